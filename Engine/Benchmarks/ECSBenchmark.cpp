@@ -0,0 +1,526 @@
+﻿/*****************************************************************//**
+ * @file	ECSBenchmark.cpp
+ * @brief	ECSのマイクロベンチマーク (ヘッドレス)。
+ *
+ * @details
+ * ウィンドウ・GPUを使わずに `World` の基本操作を計測し、結果をJSON Lines形式で標準出力へ書き出します。
+ * コミットごとの性能の推移を追跡するために、Linux (CI) でもビルド・実行できるようにしています。
+ *
+ * ### 📝 Usage
+ * ```
+ * ECSBenchmark [--counts 1000,100000,1000000] [--filter ForEach]
+ * ```
+ * ```json
+ * {"benchmark":"ForEach/4","entities":100000,"repetitions":10,"ns_per_entity":0.812,"allocs_per_op":0,"chunk_allocs_per_op":0}
+ * ```
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#include "ECS/Kernel/World.h"
+#include "ECS/Kernel/ComponentLookup.h"
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// 🧮 Allocation Counter
+// ============================================================
+// グローバルな operator new を置き換え、計測区間内のヒープ確保回数を数えます。
+// (`ChunkAllocator` のスラブ確保もここを通ります)
+
+namespace
+{
+	std::atomic<uint64_t> g_allocationCount = 0;
+
+	void* AllocateAligned(size_t size, size_t alignment)
+	{
+		size = (size + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+		return _aligned_malloc(size ? size : alignment, alignment);
+#else
+		return std::aligned_alloc(alignment, size ? size : alignment);
+#endif
+	}
+
+	void FreeAligned(void* ptr)
+	{
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+}
+
+void* operator new(size_t size)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = AllocateAligned(size, static_cast<size_t>(alignment))) return ptr;
+	throw std::bad_alloc();
+}
+
+// 置き換えた operator new は malloc で確保しているため、free での解放が正しい組み合わせです。
+// GCC はインライン展開後に new と free の組を誤検出する (-Wmismatched-new-delete) ため、ここでのみ抑制します。
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace Span::Benchmarks
+{
+	// 📦 Components
+	// ============================================================
+
+	/// @brief	計測用のコンポーネント (`Vector4` 相当の16バイト)。`N` ごとに別の型になります。
+	template <int N>
+	struct Data
+	{
+		float Value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	/// @brief	階層計測用のローカル座標
+	struct LocalPosition
+	{
+		float X = 0.0f, Y = 0.0f, Z = 0.0f;
+	};
+
+	/// @brief	階層計測用のワールド座標
+	struct WorldPosition
+	{
+		float X = 0.0f, Y = 0.0f, Z = 0.0f;
+	};
+
+	/// @brief	階層計測用の親への参照 (`Relationship::Parent` 相当)
+	struct Parent
+	{
+		Entity Value = Entity::Null;
+	};
+
+	// ⏱️ Measurement
+	// ============================================================
+
+	/// @brief	1回の計測結果
+	struct Measurement
+	{
+		double Nanoseconds = 0.0;		///< 計測区間の経過時間
+		uint64 Operations = 0;			///< 計測区間で処理したエンティティ数 (延べ)
+		uint64 Allocations = 0;			///< 計測区間のヒープ確保回数
+		uint64 ChunkAllocations = 0;	///< 計測区間の `ChunkAllocator` の確保回数
+	};
+
+	/**
+	 * @class	ScopedMeasure
+	 * @brief	スコープの生存期間を計測区間として `Measurement` に加算します。
+	 */
+	class ScopedMeasure
+	{
+	public:
+		ScopedMeasure(Measurement& result, uint64 operations)
+			: m_result(result)
+			, m_operations(operations)
+			, m_allocations(g_allocationCount.load(std::memory_order_relaxed))
+			, m_chunkAllocations(ChunkAllocator::GetStats().TotalAllocations)
+			, m_start(std::chrono::steady_clock::now())
+		{
+		}
+
+		~ScopedMeasure()
+		{
+			const auto end = std::chrono::steady_clock::now();
+			m_result.Nanoseconds += std::chrono::duration<double, std::nano>(end - m_start).count();
+			m_result.Operations += m_operations;
+			m_result.Allocations += g_allocationCount.load(std::memory_order_relaxed) - m_allocations;
+			m_result.ChunkAllocations += ChunkAllocator::GetStats().TotalAllocations - m_chunkAllocations;
+		}
+
+		SPAN_NON_COPYABLE(ScopedMeasure);
+
+	private:
+		Measurement& m_result;
+		uint64 m_operations;
+		uint64 m_allocations;
+		uint64 m_chunkAllocations;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+	/// @brief	反復系の計測で、1回の計測あたりに処理する延べエンティティ数の目安
+	static constexpr uint64 TARGET_OPERATIONS = 1'000'000;
+
+	/// @brief	`count` 体のエンティティを延べ `TARGET_OPERATIONS` 回処理するためのパス数
+	uint32 GetPassCount(uint32 count)
+	{
+		return static_cast<uint32>(std::max<uint64>(1, TARGET_OPERATIONS / count));
+	}
+
+	/// @brief	最適化で計算が消されないよう、結果を外部から見える場所へ書き出します。
+	volatile float g_sink = 0.0f;
+
+	// 🏭 Entity Management
+	// ============================================================
+
+	Measurement CreateEntity(uint32 count)
+	{
+		Measurement result;
+		World world;
+		{
+			ScopedMeasure measure(result, count);
+			for (uint32 i = 0; i < count; ++i)
+			{
+				world.CreateEntity<Data<1>, Data<2>>();
+			}
+		}
+		return result;
+	}
+
+	Measurement CreateEntities(uint32 count)
+	{
+		Measurement result;
+		World world;
+		{
+			ScopedMeasure measure(result, count);
+			world.CreateEntities<Data<1>, Data<2>>(count);
+		}
+		return result;
+	}
+
+	Measurement DestroyEntity(uint32 count)
+	{
+		Measurement result;
+		World world;
+		std::vector<Entity> entities(count);
+		world.CreateEntities<Data<1>, Data<2>>(count, entities);
+		{
+			ScopedMeasure measure(result, count);
+			for (Entity entity : entities)
+			{
+				world.DestroyEntity(entity);
+			}
+		}
+		return result;
+	}
+
+	// 🧩 Component Management
+	// ============================================================
+
+	Measurement AddComponent(uint32 count)
+	{
+		Measurement result;
+		World world;
+		std::vector<Entity> entities(count);
+		world.CreateEntities<Data<1>>(count, entities);
+		{
+			ScopedMeasure measure(result, count);
+			for (Entity entity : entities)
+			{
+				world.AddComponent<Data<2>>(entity);
+			}
+		}
+		return result;
+	}
+
+	Measurement RemoveComponent(uint32 count)
+	{
+		Measurement result;
+		World world;
+		std::vector<Entity> entities(count);
+		world.CreateEntities<Data<1>, Data<2>>(count, entities);
+		{
+			ScopedMeasure measure(result, count);
+			for (Entity entity : entities)
+			{
+				world.RemoveComponent<Data<2>>(entity);
+			}
+		}
+		return result;
+	}
+
+	// 🔄 Query / Iteration
+	// ============================================================
+
+	/// @brief	`Data<1>` ～ `Data<K>` を読み、`Data<1>` に書き込む `ForEach`
+	template <size_t... Is>
+	void ForEachData(World& world, std::index_sequence<Is...>)
+	{
+		world.ForEach<Data<1>, const Data<Is + 2>...>(
+			[](Entity, Data<1>& target, const Data<Is + 2>&... sources)
+			{
+				target.Value[0] += 1.0f;
+				((target.Value[1] += sources.Value[0]), ...);
+			}
+		);
+	}
+
+	template <size_t K>
+	Measurement ForEach(uint32 count)
+	{
+		Measurement result;
+		World world;
+		world.CreateEntities<Data<1>, Data<2>, Data<3>, Data<4>, Data<5>, Data<6>, Data<7>, Data<8>>(count);
+
+		// 初回はクエリのキャッシュ構築を含むため計測しない
+		ForEachData(world, std::make_index_sequence<K - 1>());
+
+		const uint32 passes = GetPassCount(count);
+		{
+			ScopedMeasure measure(result, static_cast<uint64>(count) * passes);
+			for (uint32 pass = 0; pass < passes; ++pass)
+			{
+				ForEachData(world, std::make_index_sequence<K - 1>());
+			}
+		}
+		return result;
+	}
+
+	/// @brief	`World::GetComponentPtr` で毎回コンポーネントを引く
+	struct DirectAccess
+	{
+		World& TargetWorld;
+
+		explicit DirectAccess(World& world) : TargetWorld(world) {}
+
+		template <typename T>
+		const T* Get(Entity entity) const { return TargetWorld.GetComponentPtr<const T>(entity); }
+	};
+
+	/// @brief	`ComponentLookup` のオフセット表からコンポーネントを引く
+	template <typename... Ts>
+	struct LookupAccess
+	{
+		std::tuple<ComponentLookup<const Ts>...> Lookups;
+
+		explicit LookupAccess(World& world) : Lookups(ComponentLookup<const Ts>(&world)...) {}
+
+		template <typename T>
+		const T* Get(Entity entity) const { return std::get<ComponentLookup<const T>>(Lookups).GetPtr(entity); }
+	};
+
+	template <typename Access>
+	Measurement RandomAccess(uint32 count)
+	{
+		Measurement result;
+		World world;
+		std::vector<Entity> entities(count);
+		world.CreateEntities<Data<1>, Data<2>>(count, entities);
+
+		std::mt19937 random(12345);
+		std::shuffle(entities.begin(), entities.end(), random);
+
+		const Access access(world);
+		const uint32 passes = GetPassCount(count);
+		float sum = 0.0f;
+		{
+			ScopedMeasure measure(result, static_cast<uint64>(count) * passes);
+			for (uint32 pass = 0; pass < passes; ++pass)
+			{
+				for (Entity entity : entities)
+				{
+					sum += access.template Get<Data<2>>(entity)->Value[0];
+				}
+			}
+		}
+		g_sink = sum;
+		return result;
+	}
+
+	// 🌳 Hierarchy
+	// ============================================================
+
+	/// @brief	親を再帰的に辿ってワールド座標を求めます (`TransformSystem::ComputeWorldMatrix` と同じ手順)。
+	template <typename Access>
+	WorldPosition ComputeWorldPosition(const Access& access, Entity entity)
+	{
+		const LocalPosition* local = access.template Get<LocalPosition>(entity);
+		if (!local) return WorldPosition{};
+
+		WorldPosition position{ local->X, local->Y, local->Z };
+		if (const Parent* parent = access.template Get<Parent>(entity))
+		{
+			if (!parent->Value.IsNull())
+			{
+				const WorldPosition parentPosition = ComputeWorldPosition(access, parent->Value);
+				position.X += parentPosition.X;
+				position.Y += parentPosition.Y;
+				position.Z += parentPosition.Z;
+			}
+		}
+		return position;
+	}
+
+	template <typename Access>
+	Measurement HierarchyUpdate(uint32 count)
+	{
+		// 4分木 (1Mで深さ10) の親子関係を作り、全エンティティのワールド座標を更新します
+		static constexpr uint32 BRANCHING = 4;
+
+		Measurement result;
+		World world;
+		std::vector<Entity> entities(count);
+		world.CreateEntities<LocalPosition, WorldPosition, Parent>(count, entities);
+		for (uint32 i = 1; i < count; ++i)
+		{
+			world.GetComponent<Parent>(entities[i]).Value = entities[(i - 1) / BRANCHING];
+			world.GetComponent<LocalPosition>(entities[i]).X = 1.0f;
+		}
+
+		const Access access(world);
+		auto update = [&]()
+		{
+			world.ForEach<const LocalPosition, WorldPosition>(
+				[&](Entity entity, const LocalPosition&, WorldPosition& position)
+				{
+					position = ComputeWorldPosition(access, entity);
+				}
+			);
+		};
+		update();
+
+		const uint32 passes = GetPassCount(count);
+		{
+			ScopedMeasure measure(result, static_cast<uint64>(count) * passes);
+			for (uint32 pass = 0; pass < passes; ++pass)
+			{
+				update();
+			}
+		}
+		return result;
+	}
+
+	// 📋 Runner
+	// ============================================================
+
+	struct Benchmark
+	{
+		const char* Name;
+		Measurement(*Run)(uint32 count);
+	};
+
+	static const Benchmark BENCHMARKS[] =
+	{
+		{ "CreateEntity",		CreateEntity },
+		{ "CreateEntities",		CreateEntities },
+		{ "DestroyEntity",		DestroyEntity },
+		{ "AddComponent",		AddComponent },
+		{ "RemoveComponent",	RemoveComponent },
+		{ "ForEach/1",			ForEach<1> },
+		{ "ForEach/2",			ForEach<2> },
+		{ "ForEach/3",			ForEach<3> },
+		{ "ForEach/4",			ForEach<4> },
+		{ "ForEach/5",			ForEach<5> },
+		{ "ForEach/6",			ForEach<6> },
+		{ "ForEach/7",			ForEach<7> },
+		{ "ForEach/8",			ForEach<8> },
+		{ "RandomAccess",			RandomAccess<DirectAccess> },
+		{ "RandomAccess/Lookup",	RandomAccess<LookupAccess<Data<2>>> },
+		{ "HierarchyUpdate",		HierarchyUpdate<DirectAccess> },
+		{ "HierarchyUpdate/Lookup",	HierarchyUpdate<LookupAccess<LocalPosition, Parent>> },
+	};
+
+	/// @brief	小さいエンティティ数でも計測誤差が揃うよう、延べ処理数に応じて繰り返し回数を決めます。
+	uint32 GetRepetitionCount(uint32 count)
+	{
+		return static_cast<uint32>(std::clamp<uint64>(TARGET_OPERATIONS / count, 3, 100));
+	}
+
+	/**
+	 * @brief	ベンチマークを繰り返し実行し、結果を1行のJSONとして出力します。
+	 * @details	時間は最速の回、確保回数は全ての回の平均を採用します。
+	 */
+	void RunBenchmark(const Benchmark& benchmark, uint32 count)
+	{
+		const uint32 repetitions = GetRepetitionCount(count);
+
+		double bestNsPerOp = DBL_MAX;
+		Measurement total;
+		for (uint32 i = 0; i < repetitions; ++i)
+		{
+			const Measurement result = benchmark.Run(count);
+			bestNsPerOp = std::min(bestNsPerOp, result.Nanoseconds / static_cast<double>(result.Operations));
+
+			total.Operations += result.Operations;
+			total.Allocations += result.Allocations;
+			total.ChunkAllocations += result.ChunkAllocations;
+		}
+
+		const double operations = static_cast<double>(total.Operations);
+		std::printf("{\"benchmark\":\"%s\",\"entities\":%u,\"repetitions\":%u,\"ns_per_entity\":%.3f,\"allocs_per_op\":%.6f,\"chunk_allocs_per_op\":%.6f}\n",
+			benchmark.Name, count, repetitions, bestNsPerOp,
+			static_cast<double>(total.Allocations) / operations,
+			static_cast<double>(total.ChunkAllocations) / operations);
+		std::fflush(stdout);
+	}
+
+	/// @brief	カンマ区切りのエンティティ数を解析します。
+	std::vector<uint32> ParseCounts(const char* text)
+	{
+		std::vector<uint32> counts;
+		std::stringstream stream(text);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			const unsigned long value = std::strtoul(item.c_str(), nullptr, 10);
+			if (value > 0 && value <= UINT32_MAX) counts.push_back(static_cast<uint32>(value));
+		}
+		return counts;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace Span::Benchmarks;
+
+	std::vector<Span::uint32> counts = { 1'000, 100'000, 1'000'000 };
+	std::string filter;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--counts" && i + 1 < argc)
+		{
+			counts = ParseCounts(argv[++i]);
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--counts 1000,100000,1000000] [--filter <name>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (counts.empty())
+	{
+		std::fprintf(stderr, "No valid entity counts.\n");
+		return 1;
+	}
+
+	for (const Benchmark& benchmark : BENCHMARKS)
+	{
+		if (!filter.empty() && std::string_view(benchmark.Name).find(filter) == std::string_view::npos) continue;
+
+		for (Span::uint32 count : counts)
+		{
+			RunBenchmark(benchmark, count);
+		}
+	}
+	return 0;
+}
@@ -5,6 +5,7 @@
  * @details
  * ほぼ全てのソースファイルでインクルードされる前提の軽量ヘッダーです。
  * 基本的な型定義、STL、Windows APIの設定、DirectXの参照を含みます。
+ * Windows以外 (ベンチマーク等のヘッドレスビルド) では、型定義とSTLのみを含みます。
  *
  * ------------------------------------------------------------
  * @author	Iwai Shogo
@@ -25,9 +26,11 @@
 #endif
 
 // Windows API
+#ifdef _WIN32
 #include <Windows.h>
 #include <wrl.h>
 #include <wrl/client.h>
+#endif
 
 // 2. Standard Library (STL)
 // ============================================================
@@ -59,7 +62,16 @@
 #include <array>
 #include <type_traits>
 #include <cfloat>
-
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <span>
+#include <bit>
+
+#ifdef _WIN32
 #include <nlohmann/json.hpp>
 
 // 3. DirectX 12 & Math
@@ -87,6 +99,7 @@
 
 using namespace Microsoft::WRL; // ComPtr用
 using namespace DirectX;		// XMMATRIX, XMFLOAT3等用
+#endif // _WIN32
 
 namespace Span
 {
@@ -0,0 +1,201 @@
+﻿#include "JobSystem.h"
+
+namespace Span
+{
+	std::vector<std::thread> JobSystem::s_workers;
+	std::vector<std::unique_ptr<JobSystem::WorkQueue>> JobSystem::s_queues;
+
+	std::mutex JobSystem::s_sleepMutex;
+	std::condition_variable JobSystem::s_sleepCondition;
+	std::atomic<uint32> JobSystem::s_queuedJobs{ 0 };
+	std::atomic<bool> JobSystem::s_running{ false };
+
+	thread_local uint32 JobSystem::s_threadIndex = JobSystem::INVALID_THREAD_INDEX;
+
+	void JobSystem::Initialize(uint32 workerCount)
+	{
+		if (IsInitialized()) return;
+
+		// 0指定なら論理コア数からメインスレッド分を引いた数
+		if (workerCount == 0)
+		{
+			uint32 hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+		}
+
+		// キューはメインスレッド用 + ワーカー数
+		s_queues.clear();
+		for (uint32 i = 0; i < workerCount + 1; ++i)
+		{
+			s_queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		s_running = true;
+		s_threadIndex = 0;
+
+		for (uint32 i = 1; i <= workerCount; ++i)
+		{
+			s_workers.emplace_back(&JobSystem::WorkerLoop, i);
+		}
+
+		SPAN_LOG("JobSystem Initialized: %u worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		if (!IsInitialized()) return;
+
+		// 残っているジョブを全て消化してから止める
+		while (TryExecuteOne(GetQueueIndex())) {}
+
+		{
+			std::lock_guard<std::mutex> lock(s_sleepMutex);
+			s_running = false;
+		}
+		s_sleepCondition.notify_all();
+
+		for (std::thread& worker : s_workers)
+		{
+			if (worker.joinable()) worker.join();
+		}
+		s_workers.clear();
+		s_queues.clear();
+	}
+
+	void JobSystem::Execute(JobCounter& counter, JobFunc job)
+	{
+		counter.Pending.fetch_add(1, std::memory_order_relaxed);
+
+		// ワーカー無しなら即時実行
+		if (!IsInitialized())
+		{
+			job();
+			counter.Pending.fetch_sub(1, std::memory_order_release);
+			return;
+		}
+
+		// 取り出し側の減算が先行しないよう、積む前に加算しておく
+		{
+			std::lock_guard<std::mutex> lock(s_sleepMutex);
+			s_queuedJobs.fetch_add(1, std::memory_order_release);
+		}
+
+		// 自スレッドのキュー末尾に積む (他スレッドは先頭から盗む)
+		WorkQueue& queue = *s_queues[GetQueueIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.emplace_back(std::move(job), &counter);
+		}
+		s_sleepCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			// 待っている間も仕事をする
+			if (!TryExecuteOne(GetQueueIndex()))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::ParallelFor(uint32 count, uint32 minBatchSize, const RangeFunc& func)
+	{
+		if (count == 0) return;
+		if (minBatchSize == 0) minBatchSize = 1;
+
+		// 分割する意味が無ければその場で実行
+		if (!IsInitialized() || count <= minBatchSize)
+		{
+			func(0, count);
+			return;
+		}
+
+		// スティールの余地を残すため、スレッド数の数倍に分割する
+		uint32 targetBatches = GetThreadCount() * 4;
+		uint32 batchSize = (count + targetBatches - 1) / targetBatches;
+		if (batchSize < minBatchSize) batchSize = minBatchSize;
+
+		JobCounter counter;
+
+		// 先頭のバッチは呼び出し元が担当する
+		for (uint32 begin = batchSize; begin < count; begin += batchSize)
+		{
+			uint32 end = (std::min)(begin + batchSize, count);
+			Execute(counter, [&func, begin, end]() { func(begin, end); });
+		}
+
+		func(0, (std::min)(batchSize, count));
+
+		Wait(counter);
+	}
+
+	void JobSystem::WorkerLoop(uint32 threadIndex)
+	{
+		s_threadIndex = threadIndex;
+
+		while (true)
+		{
+			if (TryExecuteOne(threadIndex)) continue;
+
+			// 仕事が無ければ眠る
+			std::unique_lock<std::mutex> lock(s_sleepMutex);
+			s_sleepCondition.wait(lock, []()
+			{
+				return !s_running || s_queuedJobs.load(std::memory_order_acquire) > 0;
+			});
+
+			if (!s_running) break;
+		}
+	}
+
+	bool JobSystem::TryExecuteOne(uint32 threadIndex)
+	{
+		std::pair<JobFunc, JobCounter*> job;
+		if (!PopLocal(threadIndex, job) && !Steal(threadIndex, job))
+		{
+			return false;
+		}
+
+		s_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+		job.first();
+		job.second->Pending.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	bool JobSystem::PopLocal(uint32 threadIndex, std::pair<JobFunc, JobCounter*>& outJob)
+	{
+		if (threadIndex >= s_queues.size()) return false;
+
+		WorkQueue& queue = *s_queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+		if (queue.Jobs.empty()) return false;
+
+		// 自分のキューは LIFO (キャッシュに残っているデータを優先)
+		outJob = std::move(queue.Jobs.back());
+		queue.Jobs.pop_back();
+		return true;
+	}
+
+	bool JobSystem::Steal(uint32 threadIndex, std::pair<JobFunc, JobCounter*>& outJob)
+	{
+		const uint32 queueCount = static_cast<uint32>(s_queues.size());
+
+		// 隣のスレッドから順に覗いていく
+		for (uint32 i = 1; i < queueCount; ++i)
+		{
+			WorkQueue& victim = *s_queues[(threadIndex + i) % queueCount];
+			std::lock_guard<std::mutex> lock(victim.Mutex);
+			if (victim.Jobs.empty()) continue;
+
+			// 他人のキューは FIFO (大きな塊を先に盗む)
+			outJob = std::move(victim.Jobs.front());
+			victim.Jobs.pop_front();
+			return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,142 @@
+﻿/*****************************************************************//**
+ * @file	JobSystem.h
+ * @brief	ワークスティーリング方式のジョブシステム (ワーカースレッドプール)。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include <condition_variable>
+
+namespace Span
+{
+	/**
+	 * @struct	JobCounter
+	 * @brief	発行したジョブの完了待ちに使用するカウンタ。
+	 * @details	`JobSystem::Execute` で加算され、ジョブ完了時に減算されます。
+	 */
+	struct JobCounter
+	{
+		std::atomic<uint32> Pending{ 0 };
+
+		/// @brief	全てのジョブが完了しているか
+		bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	/**
+	 * @class	JobSystem
+	 * @brief	🧵 ワーカースレッドにジョブを分配する静的クラス。
+	 *
+	 * @details
+	 * 各ワーカーは自分専用のキュー (Deque) を持ち、末尾から取り出して実行します。
+	 * 自分のキューが空になると、他のワーカーのキューの先頭からジョブを盗み (Work Stealing)、
+	 * 負荷の偏りを自動的に平準化します。
+	 *
+	 * ### 🔄 スレッドインデックス
+	 * | Index   | Thread |
+	 * | :---    | :--- |
+	 * | 0       | メインスレッド (及びワーカー以外のスレッド) |
+	 * | 1 ~ N   | ワーカースレッド |
+	 *
+	 * `Wait` を呼び出したスレッドも完了を待つ間ジョブを実行するため、メインスレッドが遊ぶことはありません。
+	 * 未初期化 (ワーカー数0) の場合、全てのジョブは呼び出し元スレッドで即時実行されます。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * JobSystem::ParallelFor(count, 64, [&](uint32 begin, uint32 end)
+	 * {
+	 *     for (uint32 i = begin; i < end; ++i) { ... }
+	 * });
+	 * ```
+	 */
+	class JobSystem
+	{
+	public:
+		/// @brief	ジョブ関数の型
+		using JobFunc = std::function<void()>;
+
+		/// @brief	範囲ジョブ関数の型 `[begin, end)`
+		using RangeFunc = std::function<void(uint32 begin, uint32 end)>;
+
+		/**
+		 * @brief	ワーカースレッドを起動します。
+		 * @param	workerCount ワーカー数。0の場合は `論理コア数 - 1` を使用します。
+		 */
+		static void Initialize(uint32 workerCount = 0);
+
+		/// @brief	全てのワーカースレッドを停止・合流させます。
+		static void Shutdown();
+
+		/// @brief	ワーカースレッドが起動しているか
+		static bool IsInitialized() { return !s_workers.empty(); }
+
+		/// @brief	ワーカースレッド数 (メインスレッドは含みません)
+		static uint32 GetWorkerCount() { return static_cast<uint32>(s_workers.size()); }
+
+		/// @brief	ジョブを実行し得るスレッドの総数 (ワーカー数 + 1)
+		static uint32 GetThreadCount() { return GetWorkerCount() + 1; }
+
+		/// @brief	`JobSystem` が管理していないスレッドのインデックス
+		static constexpr uint32 INVALID_THREAD_INDEX = UINT32_MAX;
+
+		/**
+		 * @brief	現在のスレッドのインデックス (0: メイン, 1~N: ワーカー)
+		 * @details	メインスレッドは `Initialize` を呼び出したスレッドです。
+		 *			それ以外のスレッド (および `Initialize` 前) では `INVALID_THREAD_INDEX` を返します。
+		 */
+		static uint32 GetThreadIndex() { return s_threadIndex; }
+
+		/**
+		 * @brief	ジョブを発行します。
+		 * @param	counter 完了待ち用カウンタ
+		 * @param	job 実行する関数
+		 */
+		static void Execute(JobCounter& counter, JobFunc job);
+
+		/**
+		 * @brief	カウンタが0になるまで待機します。
+		 * @details	待機中、呼び出し元スレッドもキューに残っているジョブを実行します。
+		 */
+		static void Wait(JobCounter& counter);
+
+		/**
+		 * @brief	`[0, count)` の範囲を分割し、並列に実行して完了を待ちます。
+		 * @param	count 要素数
+		 * @param	minBatchSize 1ジョブあたりの最小要素数
+		 * @param	func 範囲ごとに呼び出される関数
+		 */
+		static void ParallelFor(uint32 count, uint32 minBatchSize, const RangeFunc& func);
+
+	private:
+		/// @brief	スレッドごとのジョブキュー
+		struct WorkQueue
+		{
+			std::mutex Mutex;
+			std::deque<std::pair<JobFunc, JobCounter*>> Jobs;
+		};
+
+		/// @brief	現在のスレッドが使うキュー (管理外のスレッドはメインのキューを共有する)
+		static uint32 GetQueueIndex() { return (s_threadIndex < s_queues.size()) ? s_threadIndex : 0; }
+
+		static void WorkerLoop(uint32 threadIndex);
+		static bool TryExecuteOne(uint32 threadIndex);
+		static bool PopLocal(uint32 threadIndex, std::pair<JobFunc, JobCounter*>& outJob);
+		static bool Steal(uint32 threadIndex, std::pair<JobFunc, JobCounter*>& outJob);
+
+	private:
+		static std::vector<std::thread> s_workers;
+		static std::vector<std::unique_ptr<WorkQueue>> s_queues;	///< [0]: メイン, [1~N]: ワーカー
+
+		static std::mutex s_sleepMutex;
+		static std::condition_variable s_sleepCondition;
+		static std::atomic<uint32> s_queuedJobs;
+		static std::atomic<bool> s_running;
+
+		static thread_local uint32 s_threadIndex;
+	};
+}
@@ -1,5 +1,9 @@
 ﻿#include "Logger.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 namespace Span
 {
 	// ログファイルのポインタ
@@ -11,7 +15,12 @@ namespace Span
 		std::filesystem::create_directories("Logs");
 
 		// ファイルオープン
+#ifdef _WIN32
 		errno_t err = fopen_s(&s_LogFile, "Logs/SpanEngine.log", "w");
+#else
+		s_LogFile = fopen("Logs/SpanEngine.log", "w");
+		int err = s_LogFile ? 0 : errno;
+#endif
 		if (err != 0)
 		{
 			printf("Failed to open log file!\n");
@@ -55,12 +64,19 @@ namespace Span
 		snprintf(finalBuffer, sizeof(finalBuffer), "%s%s (%s:%d)\n", levelStr, messageBuffer, fileName.c_str(), line);
 
 		// 3. コンソール出力
+		// (Windows以外では標準出力をツールの出力に使えるよう、標準エラー出力へ書き出す)
 		SetConsoleColor(level);
+#ifdef _WIN32
 		printf("%s", finalBuffer);
+#else
+		fprintf(stderr, "%s", finalBuffer);
+#endif
 		ResetConsoleColor();
 
 		// 4. Visual Studioの出力ウィンドウへの出力
+#ifdef _WIN32
 		OutputDebugStringA(finalBuffer);
+#endif
 
 		// 5. ファイル出力
 		if (s_LogFile)
@@ -72,13 +88,18 @@ namespace Span
 		// Fatalなら強制終了
 		if (level == LogLevel::Fatal)
 		{
+#ifdef _WIN32
 			MessageBoxA(nullptr, finalBuffer, "Span Engine Fatal Error", MB_OK | MB_ICONERROR);
 			__debugbreak();	// デバッガで止める
+#else
+			std::abort();
+#endif
 		}
 	}
 
 	void Logger::SetConsoleColor(LogLevel level)
 	{
+#ifdef _WIN32
 		HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 		switch (level)
 		{
@@ -87,12 +108,27 @@ namespace Span
 		case LogLevel::Error:	SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_INTENSITY); break;					// 赤
 		case LogLevel::Fatal:	SetConsoleTextAttribute(hConsole, BACKGROUND_RED | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE | FOREGROUND_INTENSITY); break;	// 赤背景
 		}
+#else
+		// ANSIエスケープシーケンス (端末への出力時のみ)
+		if (!isatty(fileno(stderr))) return;
+		switch (level)
+		{
+		case LogLevel::Info:	break;
+		case LogLevel::Warning:	fprintf(stderr, "\033[33m"); break;		// 黄色
+		case LogLevel::Error:	fprintf(stderr, "\033[31m"); break;		// 赤
+		case LogLevel::Fatal:	fprintf(stderr, "\033[41;97m"); break;	// 赤背景
+		}
+#endif
 	}
 
 	void Logger::ResetConsoleColor()
 	{
+#ifdef _WIN32
 		HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
 		SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+#else
+		if (isatty(fileno(stderr))) fprintf(stderr, "\033[0m");
+#endif
 	}
 }
 
@@ -0,0 +1,156 @@
+﻿#include "ChunkAllocator.h"
+
+namespace Span
+{
+	void* ChunkAllocator::Allocate(size_t size)
+	{
+		const uint32 sizeClass = GetSizeClass(size);
+		if (sizeClass == SIZE_CLASS_COUNT)
+		{
+			SPAN_ERROR("ChunkAllocator: Requested block size %zu exceeds the maximum (%zu)", size, MAX_BLOCK_SIZE);
+			return nullptr;
+		}
+
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+
+		// 同じサイズクラスの、アドレスの低いスラブから埋める (高いスラブほど空になりやすく、返却しやすい)
+		auto& available = state.Available[sizeClass];
+		Slab* slab = available.empty() ? CreateSlab(state, sizeClass) : *available.begin();
+
+		// 空きリストの先頭を取り出す
+		void* block = slab->FreeList;
+		slab->FreeList = *static_cast<void**>(block);
+		slab->FreeCount--;
+		if (slab->FreeCount == 0) available.erase(slab);
+
+		state.Stats.FreeBlocks--;
+		state.Stats.UsedBlocks++;
+		state.Stats.FreeBytes -= slab->BlockSize;
+		state.Stats.UsedBytes += slab->BlockSize;
+		state.Stats.PeakUsedBlocks = (std::max)(state.Stats.PeakUsedBlocks, state.Stats.UsedBlocks);
+		state.Stats.TotalAllocations++;
+
+		return block;
+	}
+
+	void ChunkAllocator::Free(void* block)
+	{
+		if (!block) return;
+
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+
+		auto owner = state.BlockOwners.find(block);
+		if (owner == state.BlockOwners.end())
+		{
+			SPAN_ERROR("ChunkAllocator: Attempted to free a block not owned by the allocator");
+			return;
+		}
+
+		// スラブの空きリストへ戻す
+		Slab& slab = *owner->second;
+		*static_cast<void**>(block) = slab.FreeList;
+		slab.FreeList = block;
+		if (slab.FreeCount++ == 0) state.Available[slab.SizeClass].insert(&slab);
+
+		state.Stats.UsedBlocks--;
+		state.Stats.FreeBlocks++;
+		state.Stats.UsedBytes -= slab.BlockSize;
+		state.Stats.FreeBytes += slab.BlockSize;
+		state.Stats.TotalFrees++;
+
+		// スラブが丸ごと空き、かつ保持上限を超えていれば返却
+		if (slab.FreeCount == slab.BlockCount && state.Stats.FreeBytes - SLAB_SIZE >= state.RetainLimit)
+		{
+			ReleaseSlab(state, &slab);
+		}
+	}
+
+	size_t ChunkAllocator::Trim()
+	{
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+
+		std::vector<Slab*> emptySlabs;
+		for (auto& [memory, slab] : state.Slabs)
+		{
+			if (slab.FreeCount == slab.BlockCount) emptySlabs.push_back(&slab);
+		}
+
+		for (Slab* slab : emptySlabs)
+		{
+			ReleaseSlab(state, slab);
+		}
+		return emptySlabs.size() * SLAB_SIZE;
+	}
+
+	void ChunkAllocator::SetRetainLimit(size_t maxFreeBytes)
+	{
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		state.RetainLimit = maxFreeBytes;
+	}
+
+	ChunkAllocatorStats ChunkAllocator::GetStats()
+	{
+		State& state = GetState();
+		std::lock_guard<std::mutex> lock(state.Mutex);
+		return state.Stats;
+	}
+
+	ChunkAllocator::State& ChunkAllocator::GetState()
+	{
+		// 静的変数の破棄順に依存しないよう、意図的に破棄しない
+		static State* state = new State();
+		return *state;
+	}
+
+	ChunkAllocator::Slab* ChunkAllocator::CreateSlab(State& state, uint32 sizeClass)
+	{
+		uint8* memory = static_cast<uint8*>(::operator new(SLAB_SIZE, std::align_val_t(BLOCK_ALIGNMENT)));
+		Slab& slab = state.Slabs[memory];
+		slab.Memory = memory;
+		slab.SizeClass = sizeClass;
+		slab.BlockSize = BLOCK_SIZES[sizeClass];
+		slab.BlockCount = static_cast<uint32>(SLAB_SIZE / slab.BlockSize);
+
+		// 全ブロックを空きリストに繋ぐ (先頭から順に取り出されるよう逆順で積む)
+		for (uint32 i = slab.BlockCount; i > 0; --i)
+		{
+			void* block = slab.Memory + (i - 1) * slab.BlockSize;
+			*static_cast<void**>(block) = slab.FreeList;
+			slab.FreeList = block;
+			state.BlockOwners.emplace(block, &slab);
+		}
+		slab.FreeCount = slab.BlockCount;
+		state.Available[sizeClass].insert(&slab);
+
+		state.Stats.SlabCount++;
+		state.Stats.ReservedBytes += SLAB_SIZE;
+		state.Stats.FreeBlocks += slab.BlockCount;
+		state.Stats.FreeBytes += SLAB_SIZE;
+
+		return &slab;
+	}
+
+	void ChunkAllocator::ReleaseSlab(State& state, Slab* slab)
+	{
+		const uint32 blockCount = slab->BlockCount;
+		for (uint32 i = 0; i < blockCount; ++i)
+		{
+			state.BlockOwners.erase(slab->Memory + i * slab->BlockSize);
+		}
+		state.Available[slab->SizeClass].erase(slab);
+
+		uint8* memory = slab->Memory;
+		state.Slabs.erase(memory);
+		::operator delete(memory, std::align_val_t(BLOCK_ALIGNMENT));
+
+		state.Stats.SlabCount--;
+		state.Stats.ReservedBytes -= SLAB_SIZE;
+		state.Stats.FreeBlocks -= blockCount;
+		state.Stats.FreeBytes -= SLAB_SIZE;
+		state.Stats.ReleasedSlabs++;
+	}
+}
@@ -0,0 +1,154 @@
+﻿/*****************************************************************//**
+ * @file	ChunkAllocator.h
+ * @brief	ECSチャンク用のサイズクラス別ブロックアロケータ。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+
+namespace Span
+{
+	/**
+	 * @struct	ChunkAllocatorStats
+	 * @brief	📊 `ChunkAllocator` の使用状況。
+	 */
+	struct ChunkAllocatorStats
+	{
+		size_t SlabCount = 0;			///< OSから確保しているスラブ数
+		size_t ReservedBytes = 0;		///< OSから確保している総バイト数
+		uint32 UsedBlocks = 0;			///< 使用中のブロック数 (全サイズクラスの合計)
+		uint32 FreeBlocks = 0;			///< 再利用待ちのブロック数 (全サイズクラスの合計)
+		uint32 PeakUsedBlocks = 0;		///< 使用中ブロック数の最大値
+		size_t UsedBytes = 0;			///< 使用中のブロックの総バイト数
+		size_t FreeBytes = 0;			///< 再利用待ちのブロックの総バイト数
+		uint64 TotalAllocations = 0;	///< 累計の確保回数
+		uint64 TotalFrees = 0;			///< 累計の解放回数
+		uint64 ReleasedSlabs = 0;		///< OSへ返却したスラブの累計数
+	};
+
+	/**
+	 * @class	ChunkAllocator
+	 * @brief	🧱 16KB / 64KB / 256KB のブロックを大きなスラブから切り出して配る静的クラス。
+	 *
+	 * @details
+	 * OSからは `SLAB_SIZE` 単位でまとめてメモリを確保し、ページ境界 (4KB) に揃えた
+	 * ブロックとして配ります。1つのスラブは1つのサイズクラス専用で、同じサイズのブロックだけを切り出します。
+	 * 解放されたブロックはスラブごとの空きリストに戻り、アーキタイプに関係なく同じサイズの次のチャンクに再利用されます。
+	 * 空きのあるスラブはサイズクラスごとにアドレス順で管理し、ブロックから所属スラブへの索引を持つため、
+	 * 確保・解放のコストはスラブの総数に依存しません。
+	 *
+	 * ### ♻️ 返却ポリシー (Trim)
+	 * 空きブロックの総バイト数が `SetRetainLimit` で指定した値を超えている状態で、スラブ内の全ブロックが空いた場合、
+	 * そのスラブは即座にOSへ返却されます。`Trim` を呼べば空きスラブを全て返却できます。
+	 *
+	 * 全ての関数はスレッドセーフです。
+	 */
+	class ChunkAllocator
+	{
+	public:
+		/// @brief	サイズクラスの数
+		static constexpr uint32 SIZE_CLASS_COUNT = 3;
+
+		/// @brief	サイズクラスごとのブロックサイズ (昇順)
+		static constexpr std::array<size_t, SIZE_CLASS_COUNT> BLOCK_SIZES = { 16 * 1024, 64 * 1024, 256 * 1024 };
+
+		/// @brief	最小 (既定) のブロックサイズ (= ECSの既定のチャンクサイズ)
+		static constexpr size_t BLOCK_SIZE = BLOCK_SIZES.front();
+
+		/// @brief	最大のブロックサイズ
+		static constexpr size_t MAX_BLOCK_SIZE = BLOCK_SIZES.back();
+
+		/// @brief	ブロック先頭のアライメント (ページ境界)
+		static constexpr size_t BLOCK_ALIGNMENT = 4096;
+
+		/// @brief	1スラブのサイズ (1MB、全サイズクラス共通)
+		static constexpr size_t SLAB_SIZE = 1024 * 1024;
+		static_assert(SLAB_SIZE % MAX_BLOCK_SIZE == 0, "SLAB_SIZE must be a multiple of every block size");
+
+		/**
+		 * @brief	ブロックを1つ確保します。
+		 * @param	size 必要なサイズ (`BLOCK_SIZES` のうち、これ以上で最小のサイズのブロックが確保されます)
+		 * @return	`BLOCK_ALIGNMENT` に揃えられたブロックの先頭アドレス
+		 */
+		static void* Allocate(size_t size = BLOCK_SIZE);
+
+		/**
+		 * @brief	ブロックを返却します。
+		 * @param	block `Allocate` で取得したブロック (nullptrは無視されます)
+		 */
+		static void Free(void* block);
+
+		/**
+		 * @brief	全ブロックが空いているスラブを全てOSへ返却します。
+		 * @return	返却したバイト数
+		 */
+		static size_t Trim();
+
+		/**
+		 * @brief	空きスラブを即座に返却せず保持しておく空きブロックの総バイト数の上限を設定します。
+		 * @param	maxFreeBytes 上限バイト数 (Default: 4MB)
+		 */
+		static void SetRetainLimit(size_t maxFreeBytes);
+
+		/**
+		 * @brief	指定したサイズを格納できる最小のサイズクラスを取得します。
+		 * @return	`BLOCK_SIZES` の添字 (最大サイズを超える場合は `SIZE_CLASS_COUNT`)
+		 */
+		static constexpr uint32 GetSizeClass(size_t size)
+		{
+			for (uint32 i = 0; i < SIZE_CLASS_COUNT; ++i)
+			{
+				if (size <= BLOCK_SIZES[i]) return i;
+			}
+			return SIZE_CLASS_COUNT;
+		}
+
+		/// @brief	現在の使用状況を取得します。
+		static ChunkAllocatorStats GetStats();
+
+	private:
+		/// @brief	OSから確保した連続領域
+		struct Slab
+		{
+			uint8* Memory = nullptr;
+			void* FreeList = nullptr;	///< 空きブロックの単方向リスト (ブロック先頭に次のポインタを格納)
+			uint32 FreeCount = 0;
+			uint32 BlockCount = 0;		///< スラブ内のブロック数 (`SLAB_SIZE / BlockSize`)
+			size_t BlockSize = 0;
+			uint32 SizeClass = 0;
+		};
+
+		/// @brief	スラブをアドレス順に並べる比較関数
+		struct SlabAddressLess
+		{
+			bool operator()(const Slab* a, const Slab* b) const { return a->Memory < b->Memory; }
+		};
+
+		/**
+		 * @brief	アロケーターの状態
+		 * @details
+		 * 静的変数 (グローバルな `World` など) のデストラクタから `Free` が呼ばれても使えるよう、
+		 * 一度だけ確保して破棄しません。終了前に空きスラブを返却する場合は `Trim` を呼び出してください。
+		 */
+		struct State
+		{
+			std::mutex Mutex;
+			std::unordered_map<const uint8*, Slab> Slabs;					///< スラブ先頭アドレス -> スラブ
+			std::array<std::set<Slab*, SlabAddressLess>, SIZE_CLASS_COUNT> Available;	///< 空きブロックのあるスラブ (サイズクラス別、アドレス順)
+			std::unordered_map<const void*, Slab*> BlockOwners;				///< ブロック先頭アドレス -> 所属スラブ
+			size_t RetainLimit = SLAB_SIZE * 4;								///< 保持する空きブロックの総バイト数の上限
+			ChunkAllocatorStats Stats;
+		};
+
+		static State& GetState();
+
+		static Slab* CreateSlab(State& state, uint32 sizeClass);
+		static void ReleaseSlab(State& state, Slab* slab);
+	};
+}
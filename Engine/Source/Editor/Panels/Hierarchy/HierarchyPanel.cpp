@@ -17,7 +17,7 @@ namespace Span
 
 		// ルートエンティティを探して描画
 		std::vector<Entity> roots;
-		world.ForEach<Relationship>([&](Entity entity, Relationship& rel)
+		world.ForEach<const Relationship>([&](Entity entity, const Relationship& rel)
 		{
 			if (rel.Parent.IsNull())
 			{
@@ -186,10 +186,10 @@ namespace Span
 		float farClip = 1000.0f;
 
 		// シーン内のアクティブなカメラ(EditorCamera優先)を探す
-		world.ForEach<Camera, LocalToWorld>([&](Entity e, Camera& cam, LocalToWorld& ltw)
+		world.ForEach<Camera, LocalToWorld, Optional<const EditorCamera>>([&](Entity e, Camera& cam, LocalToWorld& ltw, const EditorCamera* editorCamera)
 		{
 			// EditorCameraコンポーネントを持っていればそれを優先採用
-			if (world.HasComponent<EditorCamera>(e) || cameraEntity.IsNull())
+			if (editorCamera || cameraEntity.IsNull())
 			{
 				cameraEntity = e;
 				cameraView = ltw.Value.Invert();
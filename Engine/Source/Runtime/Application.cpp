@@ -102,6 +102,9 @@ namespace Span
 		// Time
 		Time::Initialize();
 
+		// Job System (Worker Threads)
+		JobSystem::Initialize();
+
 		// Input
 		Input::Initialize(window.GetHandle());
 
@@ -129,6 +132,9 @@ namespace Span
 		// ワールド内のシステム終了処理
 		GetWorld().ShutdownSystem();
 
+		// ワーカースレッドの停止
+		JobSystem::Shutdown();
+
 		GuiManager::Shutdown();
 		sceneBuffer.Shutdown();
 		renderer.Shutdown();
@@ -231,10 +237,10 @@ namespace Span
 				GetWorld().UpdateSystems();	// Systems update
 				OnUpdate();				// User update
 
-				GetWorld().ForEach<Camera, Transform>([&](Entity, Camera&, Transform& t)
+				if (const ActiveCamera* camera = GetWorld().GetResource<const ActiveCamera>())
 				{
-					renderer.SetCameraPosition(t.Position);
-				});
+					renderer.SetCameraPosition(camera->Position);
+				}
 
 				// バリア: RTV -> SRV
 				sceneBuffer.TransitionToShaderResource(cmd);
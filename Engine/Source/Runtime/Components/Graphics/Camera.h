@@ -52,5 +52,20 @@ namespace Span
 			SPAN_FIELD(FarClip, Min(0.01f), Header("Far Clip dayo"), ReadOnly())
 		SPAN_INSPECTOR_END()
 	};
+
+	/**
+	 * @struct	ActiveCamera
+	 * @brief	🎥 描画に使用しているカメラの行列と位置 (ワールドのリソース)。
+	 *
+	 * @details
+	 * `CameraSystem` が毎フレーム `World::SetResource` で更新します。
+	 * カメラの位置が必要な処理は、`Camera` のクエリを走査せずに `World::GetResource<const ActiveCamera>()` で参照できます。
+	 */
+	struct ActiveCamera
+	{
+		Matrix4x4 ViewMatrix;		///< ビュー行列
+		Matrix4x4 ProjectionMatrix;	///< 投影行列
+		Vector3 Position;			///< ワールド空間での位置
+	};
 }
 
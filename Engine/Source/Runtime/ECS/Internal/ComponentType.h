@@ -18,16 +18,257 @@ namespace Span
 	/// @brief	コンポーネントを識別するための一意なID型 (32bit整数)
 	using ComponentTypeID = uint32;
 
+#ifndef SPAN_MAX_COMPONENT_TYPES
+	/// @brief	登録できるコンポーネント型の最大数 (共有コンポーネントを含む)。アーキタイプの署名のビット幅になります。
+	#define SPAN_MAX_COMPONENT_TYPES 256
+#endif
+
+	/// @brief	登録できるコンポーネント型の最大数 (64の倍数)
+	static constexpr uint32 MAX_COMPONENT_TYPES = SPAN_MAX_COMPONENT_TYPES;
+	static_assert(MAX_COMPONENT_TYPES > 0 && MAX_COMPONENT_TYPES % 64 == 0, "SPAN_MAX_COMPONENT_TYPES must be a multiple of 64");
+
+	namespace Detail
+	{
+		/// @brief	型名を含むコンパイラ固有の関数シグネチャ文字列
+		template <typename T>
+		constexpr std::string_view GetRawTypeName()
+		{
+#if defined(_MSC_VER)
+			return __FUNCSIG__;
+#else
+			return __PRETTY_FUNCTION__;
+#endif
+		}
+
+		/// @brief	`GetRawTypeName<T>()` の文字列から型名の部分を切り出します。
+		constexpr std::string_view ExtractTypeName(std::string_view raw)
+		{
+#if defined(_MSC_VER)
+			// "... GetRawTypeName<struct Span::Transform>(void)"
+			size_t begin = raw.find("GetRawTypeName<") + 15;
+			size_t end = raw.rfind(">(void)");
+#else
+			// "... GetRawTypeName() [with T = Span::Transform; ...]" (GCC) / "... [T = Span::Transform]" (Clang)
+			size_t begin = raw.find("T = ") + 4;
+			size_t end = raw.find(';', begin);
+			if (end == std::string_view::npos) end = raw.rfind(']');
+#endif
+			return raw.substr(begin, end - begin);
+		}
+
+		constexpr bool IsIdentifierChar(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+		}
+
+		/// @brief	`name` が "struct " / "class " / "enum " で始まっていれば、その長さを返します。
+		constexpr size_t MatchElaboratedKeyword(std::string_view name)
+		{
+			for (std::string_view keyword : { std::string_view("struct "), std::string_view("class "), std::string_view("enum ") })
+			{
+				if (name.substr(0, keyword.size()) == keyword) return keyword.size();
+			}
+			return 0;
+		}
+	}
+
 	/**
-	 * @brief	全てのコンポーネント型で共有されるIDジェネレータ
+	 * @brief	型名をコンパイル時に取得します (例: "Span::Transform")。
+	 * @note	表記はコンパイラに依存します。比較には `HashTypeName` を使用してください。
 	 */
-	class ComponentTypeCounter
+	template <typename T>
+	constexpr std::string_view GetTypeName()
+	{
+		return Detail::ExtractTypeName(Detail::GetRawTypeName<T>());
+	}
+
+	/**
+	 * @brief	型名から64bitのFNV-1aハッシュを計算します。
+	 * @details	コンパイラごとの表記揺れ (空白、`struct ` / `class ` / `enum ` の接頭辞) は無視されます。
+	 */
+	constexpr uint64 HashTypeName(std::string_view name)
+	{
+		uint64 hash = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < name.size(); ++i)
+		{
+			if (name[i] == ' ') continue;
+			if (i == 0 || !Detail::IsIdentifierChar(name[i - 1]))
+			{
+				if (size_t skip = Detail::MatchElaboratedKeyword(name.substr(i)))
+				{
+					i += skip - 1;
+					continue;
+				}
+			}
+
+			hash ^= static_cast<uint8>(name[i]);
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	/**
+	 * @struct	ComponentTypeOps
+	 * @brief	📋 `memcpy` で複製できない型のための、型ごとの複製・破棄関数。
+	 * @details	`World::Snapshot` / `Restore` で使用されます。関数が `nullptr` の型は `memcpy` / 何もしないで処理されます。
+	 */
+	struct ComponentTypeOps
+	{
+		/// @brief	`src` から `count` 個を、未初期化の `dst` へコピー構築する
+		using CopyFunc = void(*)(void* dst, const void* src, size_t count);
+		/// @brief	`data` の `count` 個のデストラクタを呼ぶ
+		using DestroyFunc = void(*)(void* data, size_t count);
+
+		CopyFunc Copy = nullptr;
+		DestroyFunc Destroy = nullptr;
+	};
+
+	namespace Detail
+	{
+		template <typename T>
+		void CopyConstructRange(void* dst, const void* src, size_t count)
+		{
+			if constexpr (std::is_copy_constructible_v<T>)
+			{
+				std::uninitialized_copy_n(static_cast<const T*>(src), count, static_cast<T*>(dst));
+			}
+			else
+			{
+				// コピーできない型 (ムーブ専用など) は既定値で埋める
+				SPAN_WARN("ComponentType: '%s' is not copy constructible. Snapshot stores default values.", typeid(T).name());
+				std::uninitialized_value_construct_n(static_cast<T*>(dst), count);
+			}
+		}
+
+		template <typename T>
+		void DestroyRange(void* data, size_t count)
+		{
+			std::destroy_n(static_cast<T*>(data), count);
+		}
+
+		template <typename T>
+		constexpr ComponentTypeOps MakeTypeOps()
+		{
+			ComponentTypeOps ops;
+			if constexpr (!std::is_empty_v<T> && !std::is_trivially_copyable_v<T>) ops.Copy = &CopyConstructRange<T>;
+			if constexpr (!std::is_empty_v<T> && !std::is_trivially_destructible_v<T>) ops.Destroy = &DestroyRange<T>;
+			return ops;
+		}
+	}
+
+	/**
+	 * @class	ComponentTypeRegistry
+	 * @brief	📇 型名ハッシュと、実行時の連番IDを対応付けるレジストリ。
+	 *
+	 * @details
+	 * 連番IDは配列の添字 (アーキタイプの署名、列番号の表など) に使うための密な番号で、登録順に振られます。
+	 * 実行ごとに変わる可能性があるため、ファイルへ保存する場合や別プロセスと共有する場合はハッシュを使用し、
+	 * 読み込み時に `FindID` で現在の実行での連番IDに変換してください。
+	 *
+	 * 異なる型名が同じハッシュを持つ (衝突する) 場合は、登録時に致命的エラーを出力します。
+	 * 全ての関数はスレッドセーフです。
+	 */
+	class ComponentTypeRegistry
 	{
 	public:
-		static ComponentTypeID GetNextID()
+		/// @brief	未登録のハッシュを表すID
+		static constexpr ComponentTypeID INVALID_ID = 0xFFFFFFFF;
+
+		/**
+		 * @brief	型を登録し、連番IDを発行します。登録済みのハッシュであれば既存のIDを返します。
+		 * @param	hash 型名のハッシュ (`HashTypeName`)
+		 * @param	name 型名 (衝突の検出とデバッグ表示用)
+		 * @param	ops 複製・破棄関数 (`memcpy` で複製できる型は空)
+		 */
+		static ComponentTypeID Register(uint64 hash, std::string_view name, const ComponentTypeOps& ops = {})
+		{
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+
+			if (auto it = data.HashToID.find(hash); it != data.HashToID.end())
+			{
+				const Entry& existing = data.Entries[it->second];
+				if (existing.Name == name) return it->second;
+
+				SPAN_FATAL("ComponentType: Type hash collision between '%s' and '%.*s'. Rename one of the types.",
+					existing.Name.c_str(), static_cast<int>(name.size()), name.data());
+			}
+
+			const ComponentTypeID id = static_cast<ComponentTypeID>(data.Entries.size());
+			if (id >= MAX_COMPONENT_TYPES)
+			{
+				SPAN_FATAL("ComponentType: Too many component types (max %u). Increase SPAN_MAX_COMPONENT_TYPES.", MAX_COMPONENT_TYPES);
+			}
+
+			data.Entries.push_back({ hash, std::string(name), ops });
+			data.HashToID.emplace(hash, id);
+			return id;
+		}
+
+		/**
+		 * @brief	ハッシュから連番IDを検索します。
+		 * @return	未登録の場合は `INVALID_ID`
+		 */
+		static ComponentTypeID FindID(uint64 hash)
+		{
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+
+			auto it = data.HashToID.find(hash);
+			return (it != data.HashToID.end()) ? it->second : INVALID_ID;
+		}
+
+		/// @brief	連番IDから型名のハッシュを取得します。
+		static uint64 GetHash(ComponentTypeID id)
+		{
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+			return (id < data.Entries.size()) ? data.Entries[id].Hash : 0;
+		}
+
+		/// @brief	連番IDから型名を取得します。
+		static std::string GetName(ComponentTypeID id)
 		{
-			static ComponentTypeID counter = 0;
-			return counter++;
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+			return (id < data.Entries.size()) ? data.Entries[id].Name : std::string();
+		}
+
+		/// @brief	連番IDから複製・破棄関数を取得します。
+		static ComponentTypeOps GetOps(ComponentTypeID id)
+		{
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+			return (id < data.Entries.size()) ? data.Entries[id].Ops : ComponentTypeOps{};
+		}
+
+		/// @brief	登録済みの型の数
+		static uint32 GetCount()
+		{
+			Data& data = GetData();
+			std::lock_guard<std::mutex> lock(data.Mutex);
+			return static_cast<uint32>(data.Entries.size());
+		}
+
+	private:
+		struct Entry
+		{
+			uint64 Hash;
+			std::string Name;
+			ComponentTypeOps Ops;
+		};
+
+		struct Data
+		{
+			std::mutex Mutex;
+			std::vector<Entry> Entries;						///< 連番ID -> 型情報
+			std::unordered_map<uint64, ComponentTypeID> HashToID;
+		};
+
+		static Data& GetData()
+		{
+			static Data data;
+			return data;
 		}
 	};
 
@@ -40,9 +281,11 @@ namespace Span
 	 * このクラスが型名からハッシュ値を計算し、自動的に一意のIDを発行します。
 	 * 
 	 * ### 🔄 ID生成フロー
-	 * 1. `typeid(T).name()` で型名文字列を取得 (例: "struct Span::Transform")
-	 * 2. `std::hash` で文字列を 32bit 整数にハッシュ化
+	 * 1. コンパイル時に型名 (例: "Span::Transform") を取得し、64bitのハッシュ (`Hash`) を計算
+	 * 2. 初回の `GetID()` で `ComponentTypeRegistry` に登録し、配列の添字に使う連番IDを受け取る
 	 * 3. 静的ローカル変数としてキャッシュし、次回以降は計算無しで返す
+	 *
+	 * `Hash` はビルドや実行が変わっても同じ値になるため、シリアライズやレイアウトのキャッシュに使用できます。
 	 * 
 	 * @tparam	T 対象となるコンポーネント構造体
 	 */
@@ -50,20 +293,29 @@ namespace Span
 	class ComponentType
 	{
 	public:
+		/// @brief	型名から計算した、実行をまたいで不変のハッシュ
+		static constexpr uint64 Hash = HashTypeName(GetTypeName<T>());
+
 		/**
 		 * @brief	型 `T` に対応する一意のIDを取得します。
-		 * @return	ハッシュ化されたコンポーネントID
-		 * @note	プログラム実行中、常に同じ値が返ることが保証されます。
+		 * @return	連番のコンポーネントID (`MAX_COMPONENT_TYPES` 未満)
+		 * @note	プログラム実行中、常に同じ値が返ることが保証されます。実行をまたいだ識別には `Hash` を使用してください。
 		 */
 		static ComponentTypeID GetID()
 		{
-			// 初回呼び出し時にのみ一意の連番IDを取得
-			static const ComponentTypeID id = ComponentTypeCounter::GetNextID();
+			// 初回呼び出し時にのみレジストリへ登録して連番IDを取得
+			static const ComponentTypeID id = ComponentTypeRegistry::Register(Hash, GetTypeName<T>(), Detail::MakeTypeOps<T>());
 			return id;
 		}
 
-		/// @brief	コンポーネントのメモリサイズ (バイト)
-		static size_t GetSize() { return sizeof(T); }
+		/**
+		 * @brief	メンバを持たないタグ型かどうか
+		 * @details	タグはアーキタイプの署名にのみ現れ、チャンク内に領域を持ちません。
+		 */
+		static constexpr bool IsTag = std::is_empty_v<T>;
+
+		/// @brief	コンポーネントのチャンク内メモリサイズ (バイト、タグは0)
+		static size_t GetSize() { return IsTag ? 0 : sizeof(T); }
 
 		/// @brief	コンポーネントのメモリアライメント要件
 		static size_t GetAlignment() { return alignof(T); }
@@ -74,5 +326,12 @@ namespace Span
 		 */
 		static const char* GetName() { return typeid(T).name(); }
 	};
+
+	/**
+	 * @brief	const修飾された型は元の型と同じIDを共有します。
+	 * @details	`ForEach<const Transform>` のように読み取り専用アクセスを表現するために使用します。
+	 */
+	template <typename T>
+	class ComponentType<const T> : public ComponentType<T> {};
 }
 
@@ -2,49 +2,34 @@
 
 namespace Span
 {
-	Archetype::Archetype(const std::vector<ComponentTypeID>& types,
-		const std::vector<size_t>& sizes,
-		const std::vector<size_t>& alignments)
-		: typeIDs(types)
+	uint32 Archetype::CalculateCapacity(size_t chunkSize, const std::vector<size_t>& sizes, const std::vector<size_t>& alignments) const
 	{
-		// signature にもIDを登録する
-		for (ComponentTypeID id : types)
-		{
-			signature.Add(id);
-		}
-
 		// 1. キャパシティの初期見積もり
 		// ------------------------------------------------------------
-		// 1エンティティ当たりの単純合計サイズを計算
-		size_t totalBytesSimple = sizeof(EntityID);
-		for (size_t size : sizes)
-		{
-			totalBytesSimple += size;
-		}
-		entitySize = totalBytesSimple;
-
-		// 余裕をもって少し少なめに見積もる
-		chunkCapacity = static_cast<uint32>((CHUNK_SIZE * 0.9f) / entitySize);
-		if (chunkCapacity == 0) chunkCapacity = 1;
+		// パディングが無い場合の上限から始める (列の境界揃えで失われるのは高々 列数 * COLUMN_ALIGNMENT バイトのため、数回の減算で収まる)
+		uint32 capacity = static_cast<uint32>(chunkSize / entitySize);
 
 		// 2. パディング考慮のリサイズ (Safe Size Calculation)
 		// ------------------------------------------------------------
-		// アライメントによって必要なメモリが増えるため、16KBに収まるまでキャパシティを減らす
-		while (chunkCapacity > 0)
+		// アライメントによって必要なメモリが増えるため、チャンクに収まるまでキャパシティを減らす
+		while (capacity > 0)
 		{
 			size_t currentOffset = 0;
 
 			// EntityID配列 (先頭)
-			currentOffset += sizeof(EntityID) * chunkCapacity;
+			currentOffset += sizeof(EntityID) * capacity;
 
 			bool fits = true;
 
 			// 各コンポーネント配列
-			for (size_t i = 0; i < types.size(); ++i)
+			for (size_t i = 0; i < sizes.size(); ++i)
 			{
-				size_t align = alignments[i];
+				size_t align = (std::max)(alignments[i], COLUMN_ALIGNMENT);
 				size_t size = sizes[i];
 
+				// タグ (サイズ0) は領域を持たない
+				if (size == 0) continue;
+
 				// パディング計算
 				if (currentOffset % align != 0)
 				{
@@ -52,10 +37,10 @@ namespace Span
 				}
 
 				// 配置後の末尾位置
-				size_t endOffset = currentOffset + (size * chunkCapacity);
+				size_t endOffset = currentOffset + (size * capacity);
 
-				// 16KBを超えたらアウト
-				if (endOffset > CHUNK_SIZE)
+				// チャンクサイズを超えたらアウト
+				if (endOffset > chunkSize)
 				{
 					fits = false;
 					break;
@@ -72,10 +57,53 @@ namespace Span
 			}
 
 			// 収まらないなら個数を減らして再計算
-			chunkCapacity--;
+			capacity--;
+		}
+
+		return capacity;
+	}
+
+	Archetype::Archetype(const std::vector<ComponentTypeID>& types,
+		const std::vector<size_t>& sizes,
+		const std::vector<size_t>& alignments,
+		const std::vector<ComponentTypeID>& sharedTypes)
+		: typeIDs(types), sharedTypeIDs(sharedTypes)
+	{
+		// signature にもIDを登録する
+		for (ComponentTypeID id : types)
+		{
+			signature.Add(id);
+		}
+		for (ComponentTypeID id : sharedTypes)
+		{
+			signature.Add(id);
+		}
+
+		// 1. 1エンティティ当たりの単純合計サイズを計算
+		// ------------------------------------------------------------
+		size_t totalBytesSimple = sizeof(EntityID);
+		for (size_t size : sizes)
+		{
+			totalBytesSimple += size;
+		}
+		entitySize = totalBytesSimple;
+
+		// 2. チャンクサイズの選択
+		// ------------------------------------------------------------
+		// 小さいサイズクラスから順に試し、目標数 (MIN_ENTITIES_PER_CHUNK) 以上が収まる最小のサイズを選ぶ
+		// (どのサイズでも目標に届かない大きなエンティティは、最大のサイズを使用する)
+		for (size_t blockSize : ChunkAllocator::BLOCK_SIZES)
+		{
+			chunkSize = blockSize;
+			chunkCapacity = CalculateCapacity(chunkSize, sizes, alignments);
+			if (chunkCapacity >= MIN_ENTITIES_PER_CHUNK) break;
 		}
 
-		if (chunkCapacity == 0) chunkCapacity = 1;
+		// 1体も収まらない場合、チャンクの範囲外へ書き込むことになるため続行できない
+		if (chunkCapacity == 0)
+		{
+			SPAN_FATAL("Archetype: Entity size (%zu bytes) exceeds the maximum chunk size (%zu bytes)", entitySize, chunkSize);
+		}
 
 		// 3. 確定したキャパシティでオフセット計算
 		// ------------------------------------------------------------
@@ -95,11 +123,20 @@ namespace Span
 		typeOffsets.resize(maxID + 1, 0);
 		typeSizes.resize(maxID + 1, 0);
 		typeAlignments.resize(maxID + 1, 0);
+		typeColumns.resize(maxID + 1, 0);
 
 		// コンポーネントごとの配列開始位置を決定
 		for (size_t i = 0; i < types.size(); ++i)
 		{
-			size_t align = alignments[i];
+			typeSizes[types[i]] = sizes[i];
+			typeAlignments[types[i]] = alignments[i];
+			typeColumns[types[i]] = static_cast<uint32>(i);
+
+			// タグは列 (変更バージョン・有効ビット) だけを持ち、配列の領域もオフセットも持たない
+			if (sizes[i] == 0) continue;
+
+			// 列の先頭はキャッシュライン境界に揃える (チャンク自体はページ境界に揃っている)
+			size_t align = (std::max)(alignments[i], COLUMN_ALIGNMENT);
 			if (finalOffset % align != 0)
 			{
 				finalOffset += align - (finalOffset % align);
@@ -107,8 +144,6 @@ namespace Span
 
 			// 配列への直接アクセス
 			typeOffsets[types[i]] = finalOffset;
-			typeSizes[types[i]] = sizes[i];
-			typeAlignments[types[i]] = alignments[i];
 
 			// 次のコンポーネントのためにオフセットを進める (サイズ * キャパシティ)
 			finalOffset += sizes[i] * chunkCapacity;
@@ -124,48 +159,42 @@ namespace Span
 		chunks.clear();
 	}
 
-	uint32 Archetype::AllocateEntity(EntityID entityID)
+	Chunk* Archetype::AllocateEntity(EntityID entityID, uint32& outIndex, std::span<const uint32> sharedValues)
 	{
-		Chunk* targetChunk = nullptr;
-
-		// 空きがあるチャンクを探す（または末尾を見る）
-		if (!chunks.empty())
-		{
-			Chunk* lastChunk = chunks.back();
-			if (lastChunk->Count < lastChunk->Capacity)
-			{
-				targetChunk = lastChunk;
-			}
-		}
-
-		// 空きがなければ新規作成
-		if (!targetChunk)
-		{
-			targetChunk = new Chunk(chunkCapacity);
-			targetChunk->OwnerArchetype = this;
-			chunks.push_back(targetChunk);
-		}
+		Chunk* targetChunk = FindOrCreateChunk(sharedValues);
 
 		// EntityIDを書き込む
-		uint32 index = targetChunk->Count;
+		outIndex = targetChunk->Count;
 
 		// チャンクの先頭はEntityID配列と決まっている
 		EntityID* ids = reinterpret_cast<EntityID*>(targetChunk->Memory);
-		ids[index] = entityID;
+		ids[outIndex] = entityID;
 
 		targetChunk->Count++;
 
-		return index;
+		return targetChunk;
+	}
+
+	Chunk* Archetype::AllocateRange(uint32 maxCount, uint32& outStartIndex, uint32& outCount, std::span<const uint32> sharedValues)
+	{
+		Chunk* targetChunk = FindOrCreateChunk(sharedValues);
+
+		// チャンクの残り容量分だけまとめて確保
+		outStartIndex = targetChunk->Count;
+		outCount = (std::min)(maxCount, targetChunk->Capacity - targetChunk->Count);
+		targetChunk->Count += outCount;
+
+		return targetChunk;
 	}
 
 	EntityID Archetype::RemoveEntity(Chunk* chunk, uint32 index)
 	{
-		// 範囲外アy不正なチャンクなら何もしない
-		if (!chunk || index >= chunk->Count) return EntityID{ 0, 0 };
+		// 範囲外や不正なチャンクなら何もしない
+		if (!chunk || index >= chunk->Count) return NullEntityID;
 
 		uint32 lastIndex = chunk->Count - 1;
 		EntityID* ids = reinterpret_cast<EntityID*>(chunk->Memory);
-		EntityID movedEntityID = { 0, 0 };
+		EntityID movedEntityID = NullEntityID;
 
 		// 削除対象が末尾の要素でなければ、末尾のデータを削除対象の位置へコピー
 		if (index < lastIndex)
@@ -181,6 +210,7 @@ namespace Span
 				ComponentTypeID typeID = typeIDs[i];
 				size_t offset = typeOffsets[typeID];
 				size_t size = typeSizes[typeID];
+				if (size == 0) continue;
 
 				// 対象コンポーネント配列の先頭ポインタ
 				uint8_t* componentArray = chunk->Memory + offset;
@@ -193,12 +223,219 @@ namespace Span
 			}
 		}
 
+		// 有効ビットも同じように穴埋めする
+		chunk->RemoveEnabledBits(index, lastIndex);
+
 		// 要素数を減らす
 		chunk->Count--;
 
+		// 空になったチャンクは走査中の可能性があるため、ここでは解放せず同期ポイントで返却する
+		if (chunk->Count == 0) hasEmptyChunks = true;
+
 		return movedEntityID;
 	}
 
+	uint32 Archetype::ReleaseEmptyChunks()
+	{
+		if (!hasEmptyChunks) return 0;
+		hasEmptyChunks = false;
+
+		uint32 released = 0;
+		std::erase_if(chunks, [&released](Chunk* chunk)
+		{
+			if (chunk->Count > 0) return false;
+
+			delete chunk;
+			released++;
+			return true;
+		});
+		return released;
+	}
+
+	Chunk* Archetype::FindOrCreateChunk(std::span<const uint32> sharedValues)
+	{
+		if (sharedTypeIDs.empty())
+		{
+			// 共有コンポーネントが無ければ末尾チャンクだけを見る
+			if (!chunks.empty() && chunks.back()->Count < chunks.back()->Capacity)
+			{
+				return chunks.back();
+			}
+		}
+		else
+		{
+			// 共有値が一致し、空きのあるチャンクを新しい方から探す
+			for (auto it = chunks.rbegin(); it != chunks.rend(); ++it)
+			{
+				Chunk* chunk = *it;
+				if (chunk->Count < chunk->Capacity &&
+					std::equal(chunk->SharedValues.begin(), chunk->SharedValues.end(), sharedValues.begin(), sharedValues.end()))
+				{
+					return chunk;
+				}
+			}
+		}
+
+		// 空きがなければ新規作成
+		return CreateChunk(sharedValues);
+	}
+
+	Chunk* Archetype::CreateChunk(std::span<const uint32> sharedValues)
+	{
+		Chunk* chunk = new Chunk(chunkCapacity, static_cast<uint32>(typeIDs.size()), chunkSize);
+		chunk->OwnerArchetype = this;
+		chunk->SharedValues.assign(sharedValues.begin(), sharedValues.end());
+		chunks.push_back(chunk);
+		return chunk;
+	}
+
+	void Archetype::ReleaseAllChunks()
+	{
+		for (Chunk* chunk : chunks)
+		{
+			delete chunk;
+		}
+		chunks.clear();
+		hasEmptyChunks = false;
+	}
+
+	uint32 Archetype::Compact(uint32 maxMoves, uint32 version, const std::function<void(EntityID, Chunk*, uint32)>& onMoved)
+	{
+		// 空のチャンクは移動元にならないよう先に返却する
+		ReleaseEmptyChunks();
+		if (maxMoves == 0 || !IsFragmented()) return 0;
+
+		// 共有値ごとにまとめ、その中では要素数の多い順に並べる
+		std::vector<Chunk*> order = chunks;
+		std::stable_sort(order.begin(), order.end(), [](const Chunk* a, const Chunk* b)
+		{
+			if (a->SharedValues != b->SharedValues) return a->SharedValues < b->SharedValues;
+			return a->Count > b->Count;
+		});
+
+		uint32 moved = 0;
+		size_t groupBegin = 0;
+		while (groupBegin < order.size() && moved < maxMoves)
+		{
+			size_t groupEnd = groupBegin + 1;
+			while (groupEnd < order.size() && order[groupEnd]->SharedValues == order[groupBegin]->SharedValues) ++groupEnd;
+
+			// 前方 (密) を移動先、後方 (疎) を移動元として両端から詰める
+			size_t dst = groupBegin;
+			size_t src = groupEnd - 1;
+			Chunk* lastMarked = nullptr;
+			while (dst < src && moved < maxMoves)
+			{
+				Chunk* to = order[dst];
+				if (to->Count == to->Capacity)
+				{
+					++dst;
+					continue;
+				}
+
+				// 移動元の末尾のエンティティを、移動先の末尾へコピー
+				Chunk* from = order[src];
+				uint32 fromIndex = from->Count - 1;
+				uint32 toIndex = to->Count;
+
+				EntityID* fromIDs = reinterpret_cast<EntityID*>(from->Memory);
+				EntityID* toIDs = reinterpret_cast<EntityID*>(to->Memory);
+				EntityID movedID = fromIDs[fromIndex];
+				toIDs[toIndex] = movedID;
+
+				for (uint32 column = 0; column < static_cast<uint32>(typeIDs.size()); ++column)
+				{
+					// 無効化状態も引き継ぐ
+					if (from->HasDisabled(column) && !from->IsEnabled(column, fromIndex))
+					{
+						to->SetEnabled(column, toIndex, false);
+					}
+
+					size_t size = typeSizes[typeIDs[column]];
+					if (size == 0) continue;
+
+					uint8* base = to->Memory + typeOffsets[typeIDs[column]];
+					std::memcpy(base + size * toIndex, from->Memory + typeOffsets[typeIDs[column]] + size * fromIndex, size);
+				}
+				to->Count++;
+
+				if (to != lastMarked)
+				{
+					to->MarkAllChanged(version);
+					lastMarked = to;
+				}
+
+				// 末尾からの削除なので穴埋めは発生しない (空になったチャンクは最後にまとめて返却する)
+				bool emptied = (from->Count == 1);
+				RemoveEntity(from, fromIndex);
+				if (emptied) --src;
+
+				onMoved(movedID, to, toIndex);
+				moved++;
+			}
+
+			groupBegin = groupEnd;
+		}
+
+		ReleaseEmptyChunks();
+
+		// 空きのあるチャンクを末尾に寄せ、新規確保がそこから埋まるようにする
+		std::stable_sort(chunks.begin(), chunks.end(), [](const Chunk* a, const Chunk* b) { return a->Count > b->Count; });
+
+		return moved;
+	}
+
+	bool Archetype::IsFragmented() const
+	{
+		if (sharedTypeIDs.empty())
+		{
+			uint32 partial = 0;
+			for (const Chunk* chunk : chunks)
+			{
+				if (chunk->Count < chunk->Capacity && ++partial > 1) return true;
+			}
+			return false;
+		}
+
+		// 共有値ごとに数える
+		std::vector<const std::vector<uint32>*> seen;
+		for (const Chunk* chunk : chunks)
+		{
+			if (chunk->Count == chunk->Capacity) continue;
+
+			for (const std::vector<uint32>* values : seen)
+			{
+				if (*values == chunk->SharedValues) return true;
+			}
+			seen.push_back(&chunk->SharedValues);
+		}
+		return false;
+	}
+
+	void Archetype::DetachChunk(Chunk* chunk)
+	{
+		auto it = std::find(chunks.begin(), chunks.end(), chunk);
+		if (it == chunks.end()) return;
+
+		chunks.erase(it);
+		chunk->OwnerArchetype = nullptr;
+	}
+
+	void Archetype::AdoptChunk(Chunk* chunk)
+	{
+		chunk->OwnerArchetype = this;
+
+		// 共有コンポーネントが無い場合、確保は末尾チャンクの空きだけを見るため、末尾に空きがあれば手前に挿入して活かす
+		if (!chunks.empty() && chunks.back()->Count < chunks.back()->Capacity)
+		{
+			chunks.insert(chunks.end() - 1, chunk);
+		}
+		else
+		{
+			chunks.push_back(chunk);
+		}
+	}
+
 	size_t Archetype::GetComponentOffset(ComponentTypeID typeID) const
 	{
 		return (typeID < typeOffsets.size()) ? typeOffsets[typeID] : 0;
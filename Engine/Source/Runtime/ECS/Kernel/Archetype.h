@@ -23,19 +23,25 @@ namespace Span
 	 * @brief	🔑 アーキタイプを識別するための署名キー
 	 * 
 	 * @details
-	 * 持っているコンポーネントIDのリストをソートして保持します。
-	 * これにより、追加順序に関わらず「構成が同じなら同じ署名」とみなされます。
+	 * 持っているコンポーネントIDを、`MAX_COMPONENT_TYPES` ビットの固定長ビット集合として保持します。
+	 * 追加順序に関わらず「構成が同じなら同じ署名」とみなされ、追加・削除・判定はいずれもビット演算1回です。
+	 *
+	 * 集合同士の比較 (`Contains` / `Intersects` / `operator==`) は64ビット単位のAND/XORの固定回数ループで、
+	 * コンパイラによってSIMD命令にベクトル化されます。
 	 */
 	class ArchetypeSignature
 	{
 	public:
+		/// @brief	64ビットワードの数
+		static constexpr uint32 WORD_COUNT = MAX_COMPONENT_TYPES / 64;
+
 		/**
-		 * @brief	コンポーネントIDを追加して再ソートします。
+		 * @brief	コンポーネントIDを追加します。
 		 */
 		void Add(ComponentTypeID typeID)
 		{
-			componentTypes.push_back(typeID);
-			std::sort(componentTypes.begin(), componentTypes.end());
+			assert(typeID < MAX_COMPONENT_TYPES && "ComponentTypeID exceeds SPAN_MAX_COMPONENT_TYPES");
+			words[typeID >> 6] |= 1ull << (typeID & 63);
 		}
 
 		/**
@@ -43,12 +49,8 @@ namespace Span
 		 */
 		void Remove(ComponentTypeID typeID)
 		{
-			// erase-remove idiom
-			auto it = std::remove(componentTypes.begin(), componentTypes.end(), typeID);
-			if (it != componentTypes.end())
-			{
-				componentTypes.erase(it, componentTypes.end());
-			}
+			if (typeID >= MAX_COMPONENT_TYPES) return;
+			words[typeID >> 6] &= ~(1ull << (typeID & 63));
 		}
 
 		/**
@@ -56,25 +58,65 @@ namespace Span
 		 */
 		bool Has(ComponentTypeID typeID) const
 		{
-			return std::binary_search(componentTypes.begin(), componentTypes.end(), typeID);
+			if (typeID >= MAX_COMPONENT_TYPES) return false;
+			return (words[typeID >> 6] >> (typeID & 63)) & 1;
 		}
 
-		/// @brief Operators
-		/// @{
-		bool operator<(const ArchetypeSignature& other) const
+		/**
+		 * @brief	`subset` の全てのコンポーネントを含んでいるか判定します。
+		 */
+		bool Contains(const ArchetypeSignature& subset) const
+		{
+			uint64 missing = 0;
+			for (uint32 i = 0; i < WORD_COUNT; ++i)
+			{
+				missing |= subset.words[i] & ~words[i];
+			}
+			return missing == 0;
+		}
+
+		/**
+		 * @brief	`other` と共通のコンポーネントを1つでも持つか判定します。
+		 */
+		bool Intersects(const ArchetypeSignature& other) const
 		{
-			return componentTypes < other.componentTypes;
+			uint64 common = 0;
+			for (uint32 i = 0; i < WORD_COUNT; ++i)
+			{
+				common |= words[i] & other.words[i];
+			}
+			return common != 0;
+		}
+
+		/**
+		 * @brief	ハッシュ値を計算します (アーキタイプのハッシュテーブル用)。
+		 */
+		uint64 GetHash() const
+		{
+			uint64 hash = 0xcbf29ce484222325ull;
+			for (uint32 i = 0; i < WORD_COUNT; ++i)
+			{
+				hash = (hash ^ words[i]) * 0x9e3779b97f4a7c15ull;
+				hash ^= hash >> 32;
+			}
+			return hash;
 		}
+
+		/// @brief Operators
+		/// @{
 		bool operator==(const ArchetypeSignature& other) const
 		{
-			return componentTypes == other.componentTypes;
+			uint64 diff = 0;
+			for (uint32 i = 0; i < WORD_COUNT; ++i)
+			{
+				diff |= words[i] ^ other.words[i];
+			}
+			return diff == 0;
 		}
 		/// @}
 
-		const std::vector<ComponentTypeID>& GetTypes() const { return componentTypes; }
-
 	private:
-		std::vector<ComponentTypeID> componentTypes;
+		std::array<uint64, WORD_COUNT> words = {};
 	};
 
 	/**
@@ -82,8 +124,11 @@ namespace Span
 	 * @brief	🏢 エンティティのコンテナクラス。メモリレイアウトを管理します。
 	 * 
 	 * @details
-	 * 1つのアーキタイプは複数の `Chunk` (16KBブロック) を持ち、
+	 * 1つのアーキタイプは複数の `Chunk` (既定16KBブロック) を持ち、
 	 * コンポーネントデータを **SoA (Structure of Arrays)** 形式で格納します。
+	 *
+	 * チャンクのサイズはアーキタイプごとに、エンティティ1体分のサイズから 16KB / 64KB / 256KB のいずれかが選ばれます。
+	 * 1チャンクに `MIN_ENTITIES_PER_CHUNK` 体以上が収まる、最小のサイズが使用されます。
 	 * 
 	 * ### 🧠 メモリレイアウト (Chunk Memory Layout)
 	 * 例: `Transform` (Vec3) と `Velocity` (Vec3) を持つアーキタイプの場合
@@ -92,6 +137,11 @@ namespace Span
 	 * | ...    | `[0][1][2]...` | `[Pos][Pos][Pos]...` | `[Vel][Vel][Vel]...` | ... |
 	 * 
 	 * これにより、同じコンポーネントへの連続アクセスがキャッシュフレンドリーになります。
+	 * メンバを持たないタグ型 (`std::is_empty_v`) は列番号だけを持ち、チャンク内の領域は消費しません。
+	 *
+	 * ### 🤝 共有コンポーネント (Shared Components)
+	 * 共有コンポーネントはチャンク内に列を持たず、チャンクごとに値の番号 (`Chunk::SharedValues`) を1組だけ持ちます。
+	 * 番号の組み合わせが異なるエンティティは、同じアーキタイプでも別のチャンクに分けて格納されます。
 	 */
 	class Archetype
 	{
@@ -101,10 +151,12 @@ namespace Span
 		 * @param	types コンポーネント型IDのリスト
 		 * @param	sizes 各コンポーネントのサイズ
 		 * @param	alignments 各コンポーネントのアライメント要件
+		 * @param	sharedTypes 共有コンポーネントの型IDのリスト (`ComponentType<Shared<T>>::GetID()`)
 		 */
 		Archetype(const std::vector<ComponentTypeID>& types,
 			const std::vector<size_t>& sizes,
-			const std::vector<size_t>& alignments);
+			const std::vector<size_t>& alignments,
+			const std::vector<ComponentTypeID>& sharedTypes = {});
 
 		~Archetype();
 
@@ -121,6 +173,11 @@ namespace Span
 			return signature.Has(typeID);
 		}
 
+		/**
+		 * @brief	コンポーネントの構成の署名 (共有コンポーネントを含む) を取得します。
+		 */
+		const ArchetypeSignature& GetSignature() const { return signature; }
+
 		/**
 		 * @brief	要求された全てのコンポーネントを持っているか確認します。
 		 * @param	queryTypes 要求するコンポーネントIDリスト
@@ -145,18 +202,100 @@ namespace Span
 		 * @details
 		 * 空きのあるChunkを探し、なければ新しいChunkを確保します。
 		 * @param	entityID 割り当てるエンティティID
-		 * @return	Chunk内でのインデックス
+		 * @param	outIndex 確保したChunk内でのインデックス
+		 * @param	sharedValues 共有コンポーネントの値の番号 (`GetSharedTypes()` の順)
+		 * @return	確保したチャンク
+		 */
+		Chunk* AllocateEntity(EntityID entityID, uint32& outIndex, std::span<const uint32> sharedValues = {});
+
+		/**
+		 * @brief	複数Entity用のスペースを、1つのチャンク内で連続して確保します。
+		 *
+		 * @details
+		 * 空きのあるチャンク (無ければ新規チャンク) から最大 `maxCount` 個を確保します。
+		 * EntityIDの書き込みとコンポーネントの初期化は呼び出し側が行います。
+		 * 全数を確保するまで繰り返し呼び出してください。
+		 * @param	maxCount 確保したい最大数
+		 * @param	outStartIndex 確保した範囲のチャンク内先頭インデックス
+		 * @param	outCount 実際に確保できた数 (1 ~ maxCount)
+		 * @param	sharedValues 共有コンポーネントの値の番号 (`GetSharedTypes()` の順)
+		 * @return	確保したチャンク
 		 */
-		uint32 AllocateEntity(EntityID entityID);
+		Chunk* AllocateRange(uint32 maxCount, uint32& outStartIndex, uint32& outCount, std::span<const uint32> sharedValues = {});
 
 		/**
 		 * @brief	指定したチャンク内のエンティティデータを削除し、末尾の要素で穴埋めします。
+		 * @details
+		 * 削除によってチャンクが空になっても、チャンクは配列に残ります (走査中のチャンクを解放しないため)。
+		 * 空のチャンクは同期ポイントで `ReleaseEmptyChunks` によりまとめて返却されます。
 		 * @param	chunk 対象のチャンクポインタ
 		 * @param	index チャンク内での削除対象のインデックス
-		 * @return	移動によってインデックスが変わったエンティティのID。穴埋めが発生しなかった場合は無効なID。
+		 * @return	移動によってインデックスが変わったエンティティのID。穴埋めが発生しなかった場合は `NullEntityID`。
 		 */
 		EntityID RemoveEntity(Chunk* chunk, uint32 index);
 
+		/**
+		 * @brief	空になったチャンクをプールへ返却し、他のアーキタイプで再利用させます。
+		 * @note	チャンクの配列が変わるため、チャンクの走査中には呼び出さないでください (同期ポイント専用)。
+		 * @return	返却したチャンク数
+		 */
+		uint32 ReleaseEmptyChunks();
+
+		/// @brief	`ReleaseEmptyChunks` で返却すべき空のチャンクがあるか
+		bool HasEmptyChunks() const { return hasEmptyChunks; }
+
+		/**
+		 * @brief	疎なチャンクのエンティティを密なチャンクへ詰め直し、空いたチャンクを返却します。
+		 *
+		 * @details
+		 * 共有値が同じチャンク同士で、最も空いているチャンクの末尾から、最も埋まっている (満杯でない) チャンクへ移動します。
+		 * 移動先のチャンクは全列が変更扱いになります。処理後、チャンクは要素数の多い順に並べ替えられます。
+		 * @param	maxMoves 移動するエンティティ数の上限
+		 * @param	version 移動先チャンクに記録する変更バージョン
+		 * @param	onMoved 移動したエンティティごとに `(EntityID, 移動先チャンク, 移動先インデックス)` で呼ばれます
+		 * @return	移動したエンティティ数
+		 */
+		uint32 Compact(uint32 maxMoves, uint32 version, const std::function<void(EntityID, Chunk*, uint32)>& onMoved);
+
+		/**
+		 * @brief	詰め直しの余地があるか (空きのあるチャンクが、共有値ごとに2つ以上あるか) を判定します。
+		 */
+		bool IsFragmented() const;
+
+		/**
+		 * @brief	チャンクを管理対象から外します (メモリは解放しません)。
+		 * @details	`AdoptChunk` と組み合わせて、チャンクを丸ごと別のアーキタイプ (別のワールド) へ受け渡すために使用します。
+		 */
+		void DetachChunk(Chunk* chunk);
+
+		/**
+		 * @brief	他のアーキタイプから外されたチャンクを受け取ります。
+		 * @note	元のアーキタイプと `HasSameLayout` であること。
+		 */
+		void AdoptChunk(Chunk* chunk);
+
+		/**
+		 * @brief	指定した共有値を持つ、空のチャンクを末尾に作成します。
+		 * @details	通常の確保は `AllocateEntity` / `AllocateRange` を使用してください (`World::Restore` 用)。
+		 */
+		Chunk* CreateChunk(std::span<const uint32> sharedValues);
+
+		/**
+		 * @brief	全てのチャンクを返却します。
+		 * @note	コンポーネントのデストラクタは呼ばれません。エンティティの住所録は呼び出し側で更新してください。
+		 */
+		void ReleaseAllChunks();
+
+		/**
+		 * @brief	チャンクのレイアウト (型と共有型の並び、キャパシティ) が同じか判定します。
+		 * @details	同じであれば、チャンクのメモリ・列ごとのデータをそのまま受け渡せます。
+		 */
+		bool HasSameLayout(const Archetype& other) const
+		{
+			return typeIDs == other.typeIDs && sharedTypeIDs == other.sharedTypeIDs
+				&& chunkSize == other.chunkSize && chunkCapacity == other.chunkCapacity;
+		}
+
 		/**
 		 * @brief	コンポーネント配列の「チャンク内オフセット」を取得します。
 		 * @param	typeID コンポーネント型ID
@@ -174,6 +313,25 @@ namespace Span
 		 */
 		size_t GetComponentAlignment(ComponentTypeID typeID) const;
 
+		/**
+		 * @brief	コンポーネントの列番号 (`GetTypes()` 内での位置) を取得します。
+		 * @details	チャンクの変更バージョンなど、列ごとのデータの添字として使用します。
+		 */
+		uint32 GetColumnIndex(ComponentTypeID typeID) const
+		{
+			return (typeID < typeColumns.size()) ? typeColumns[typeID] : 0;
+		}
+
+		/**
+		 * @brief	共有コンポーネントの番号 (`GetSharedTypes()` 内での位置) を取得します。
+		 * @details	`Chunk::SharedValues` の添字として使用します。
+		 */
+		uint32 GetSharedIndex(ComponentTypeID sharedID) const
+		{
+			auto it = std::find(sharedTypeIDs.begin(), sharedTypeIDs.end(), sharedID);
+			return static_cast<uint32>(it - sharedTypeIDs.begin());
+		}
+
 		// 📊 Getters
 		// ============================================================
 
@@ -182,29 +340,106 @@ namespace Span
 		 */
 		const std::vector<Chunk*>& GetChunks() const { return chunks; }
 
+		/**
+		 * @brief	ワールド内での生成順の番号 (`ArchetypeManager::GetArchetypeList()` 内での位置)
+		 * @details	アーキタイプごとのキャッシュ (`ComponentLookup` など) の添字として使用します。
+		 */
+		uint32 GetIndex() const { return index; }
+
+		/// @brief	生成順の番号を設定します (`ArchetypeManager` 用)。
+		void SetIndex(uint32 value) { index = value; }
+
 		/**
 		 * @brief	1つのチャンクに格納できるエンティティ最大数
 		 */
 		uint32 GetChunkCapacity() const { return chunkCapacity; }
 
+		/**
+		 * @brief	1つのチャンクのメモリサイズ (`ChunkAllocator::BLOCK_SIZES` のいずれか)
+		 */
+		size_t GetChunkSize() const { return chunkSize; }
+
+		/**
+		 * @brief	エンティティ1体分のデータサイズ (EntityIDと全コンポーネントの合計、パディングを含まない)
+		 */
+		size_t GetEntitySize() const { return entitySize; }
+
 		/**
 		 * @brief	構成コンポーネントの型リスト
 		 */
 		const std::vector<ComponentTypeID>& GetTypes() const { return typeIDs; }
 
+		/**
+		 * @brief	共有コンポーネントの型リスト
+		 */
+		const std::vector<ComponentTypeID>& GetSharedTypes() const { return sharedTypeIDs; }
+
+		// 🔀 Transition Graph
+		// ============================================================
+
+		/**
+		 * @brief	コンポーネントを1つ追加した場合の遷移先アーキタイプを取得します。
+		 * @param	typeID 追加するコンポーネント型ID
+		 * @return	キャッシュ済みの遷移先。未登録の場合は `nullptr`。
+		 */
+		Archetype* GetAddEdge(ComponentTypeID typeID) const
+		{
+			return (typeID < addEdges.size()) ? addEdges[typeID] : nullptr;
+		}
+
+		/**
+		 * @brief	コンポーネントを1つ削除した場合の遷移先アーキタイプを取得します。
+		 * @param	typeID 削除するコンポーネント型ID
+		 * @return	キャッシュ済みの遷移先。未登録の場合は `nullptr`。
+		 */
+		Archetype* GetRemoveEdge(ComponentTypeID typeID) const
+		{
+			return (typeID < removeEdges.size()) ? removeEdges[typeID] : nullptr;
+		}
+
+		/// @brief	追加方向の遷移先を登録します。
+		void SetAddEdge(ComponentTypeID typeID, Archetype* target)
+		{
+			if (typeID >= addEdges.size()) addEdges.resize(typeID + 1, nullptr);
+			addEdges[typeID] = target;
+		}
+
+		/// @brief	削除方向の遷移先を登録します。
+		void SetRemoveEdge(ComponentTypeID typeID, Archetype* target)
+		{
+			if (typeID >= removeEdges.size()) removeEdges.resize(typeID + 1, nullptr);
+			removeEdges[typeID] = target;
+		}
+
+	private:
+		/// @brief	指定したサイズのチャンクに、列の境界揃えを考慮して何体収まるかを計算します。
+		uint32 CalculateCapacity(size_t chunkSize, const std::vector<size_t>& sizes, const std::vector<size_t>& alignments) const;
+
+		/// @brief	指定した共有値を持ち、空きのあるチャンクを探します。無ければ新規に作成します。
+		Chunk* FindOrCreateChunk(std::span<const uint32> sharedValues);
+
 	private:
-		ArchetypeSignature signature;	///< コンポーネントの構成の署名
+		ArchetypeSignature signature;	///< コンポーネントの構成の署名 (共有コンポーネントを含む)
+		uint32 index = 0;				///< ワールド内での生成順の番号
 
 		// --- Layout Info ---
 		std::vector<ComponentTypeID> typeIDs;	///< TypeIDリスト
 		std::vector<size_t> typeOffsets;		///< TypeID -> Chunk内オフセット
 		std::vector<size_t> typeSizes;			///< TypeID -> サイズ (バイト)
 		std::vector<size_t> typeAlignments;		///< TypeID -> アライメント
+		std::vector<uint32> typeColumns;		///< TypeID -> 列番号
+		std::vector<ComponentTypeID> sharedTypeIDs;	///< 共有コンポーネントのTypeIDリスト
 
 		size_t entitySize = 0;					///< Entity1体あたりの合計サイズ (バイト)
 		uint32 chunkCapacity = 0;				///< 1チャンクに何体入るか
+		size_t chunkSize = CHUNK_SIZE;			///< 1チャンクのメモリサイズ (バイト)
 
 		// --- Storage ---
 		std::vector<Chunk*> chunks;				///< 確保されたメモリブロック群
+		bool hasEmptyChunks = false;			///< 返却待ちの空のチャンクがあるか
+
+		// --- Transition Graph ---
+		std::vector<Archetype*> addEdges;		///< TypeID -> そのコンポーネントを追加した遷移先
+		std::vector<Archetype*> removeEdges;	///< TypeID -> そのコンポーネントを削除した遷移先
 	};
 }
@@ -23,17 +23,22 @@ namespace Span
 	 * コンポーネントの組み合わせごとに一意の `Archetype` インスタンスを管理します。
 	 * 同じ組み合わせ (例: Transform + Velocity) が要求された場合、
 	 * 新しく作成せず、既存のキャッシュされたアーキタイプを返します。
+	 *
+	 * ### #️⃣ 検索 (Hash Lookup)
+	 * アーキタイプは署名のハッシュ値をキーにしたオープンアドレス法 (線形探索) のテーブルで管理します。
+	 * アーキタイプは削除されないため、削除済みの印 (tombstone) は不要です。
 	 */
 	class ArchetypeManager
 	{
 	public:
 		~ArchetypeManager()
 		{
-			for (auto& pair : archetypes)
+			for (Archetype* archetype : archetypeList)
 			{
-				delete pair.second;
+				delete archetype;
 			}
-			archetypes.clear();
+			archetypeList.clear();
+			slots.clear();
 		}
 
 		/**
@@ -56,20 +61,20 @@ namespace Span
 			(signature.Add(ComponentType<ComponentTypes>::GetID()), ...);
 
 			// 2. 既に存在すればそれを返す
-			auto it = archetypes.find(signature);
-			if (it != archetypes.end())
+			const uint64 hash = signature.GetHash();
+			if (Archetype* found = Find(signature, hash))
 			{
-				return it->second;
+				return found;
 			}
 
 			// 3. なければ新規作成
 			// 型ID、サイズ、アライメントのリストを作成
 			std::vector<ComponentTypeID> typeIDs = { ComponentType<ComponentTypes>::GetID()... };
-			std::vector<size_t> sizes = { sizeof(ComponentTypes)... };
+			std::vector<size_t> sizes = { ComponentType<ComponentTypes>::GetSize()... };
 			std::vector<size_t> alignments = { alignof(ComponentTypes)... };
 
 			Archetype* newArchetype = new Archetype(typeIDs, sizes, alignments);
-			archetypes[signature] = newArchetype;
+			Insert(newArchetype, hash);
 
 			SPAN_LOG("Created new Archetype. Signature size: %zu", typeIDs.size());
 
@@ -79,34 +84,111 @@ namespace Span
 		/**
 		 * @brief	動的なIDリストからアーキタイプを取得または作成します。
 		 * @details	AddComponent/RemoveComponentなど、型情報が動的に変わる場合に使用します。
+		 * @param	sharedTypes 共有コンポーネントの型IDリスト
 		 */
 		Archetype* GetOrCreateArchetype(
 			const std::vector<ComponentTypeID>& typeIDs,
 			const std::vector<size_t>& sizes,
-			const std::vector<size_t>& alignments)
+			const std::vector<size_t>& alignments,
+			const std::vector<ComponentTypeID>& sharedTypes = {})
 		{
 			ArchetypeSignature signature;
 			for (auto id : typeIDs)
 			{
 				signature.Add(id);
 			}
+			for (auto id : sharedTypes)
+			{
+				signature.Add(id);
+			}
 
-			if (auto it = archetypes.find(signature); it != archetypes.end())
+			const uint64 hash = signature.GetHash();
+			if (Archetype* found = Find(signature, hash))
 			{
-				return it->second;
+				return found;
 			}
 
-			Archetype* newArchetype = new Archetype(typeIDs, sizes, alignments);
-			archetypes[signature] = newArchetype;
+			Archetype* newArchetype = new Archetype(typeIDs, sizes, alignments, sharedTypes);
+			Insert(newArchetype, hash);
 			return newArchetype;
 		}
 
-		/// @brief	管理している全アーキタイプを取得 (イテレーション用)
-		const std::map<ArchetypeSignature, Archetype*>& GetAllArchetypes() const { return archetypes; }
+		/**
+		 * @brief	署名に一致するアーキタイプを検索します。
+		 * @return	見つからなければ `nullptr`
+		 */
+		Archetype* FindArchetype(const ArchetypeSignature& signature) const
+		{
+			return Find(signature, signature.GetHash());
+		}
+
+		/**
+		 * @brief	全アーキタイプを生成順に取得します。
+		 * @details	アーキタイプは削除されないため、要素は末尾に追加されるのみです。
+		 *			クエリはこの性質を利用し、前回以降に追加された分だけを差分検査します。
+		 */
+		const std::vector<Archetype*>& GetArchetypeList() const { return archetypeList; }
+
+	private:
+		/// @brief	ハッシュテーブルの1要素
+		struct Slot
+		{
+			uint64 Hash = 0;
+			Archetype* Value = nullptr;	///< nullptrなら空き
+		};
+
+		Archetype* Find(const ArchetypeSignature& signature, uint64 hash) const
+		{
+			if (slots.empty()) return nullptr;
+
+			const size_t mask = slots.size() - 1;
+			for (size_t i = hash & mask; ; i = (i + 1) & mask)
+			{
+				const Slot& slot = slots[i];
+				if (!slot.Value) return nullptr;
+				if (slot.Hash == hash && slot.Value->GetSignature() == signature) return slot.Value;
+			}
+		}
+
+		void Insert(Archetype* archetype, uint64 hash)
+		{
+			// 負荷率を 1/2 以下に保つ (容量は2の累乗)
+			if ((archetypeList.size() + 1) * 2 > slots.size())
+			{
+				Rehash((std::max)(slots.size() * 2, size_t(64)));
+			}
+
+			const size_t mask = slots.size() - 1;
+			size_t i = hash & mask;
+			while (slots[i].Value) i = (i + 1) & mask;
+			slots[i] = { hash, archetype };
+
+			archetype->SetIndex(static_cast<uint32>(archetypeList.size()));
+			archetypeList.push_back(archetype);
+		}
+
+		void Rehash(size_t capacity)
+		{
+			std::vector<Slot> old = std::move(slots);
+			slots.assign(capacity, Slot{});
+
+			const size_t mask = capacity - 1;
+			for (const Slot& slot : old)
+			{
+				if (!slot.Value) continue;
+
+				size_t i = slot.Hash & mask;
+				while (slots[i].Value) i = (i + 1) & mask;
+				slots[i] = slot;
+			}
+		}
 
 	private:
-		// 署名をキーにしてアーキタイプを保存
-		std::map<ArchetypeSignature, Archetype*> archetypes;
+		// 署名のハッシュをキーにしたオープンアドレス法のテーブル
+		std::vector<Slot> slots;
+
+		// 生成順のリスト (クエリの差分更新用)
+		std::vector<Archetype*> archetypeList;
 	};
 }
 
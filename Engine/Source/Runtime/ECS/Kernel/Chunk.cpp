@@ -4,18 +4,23 @@
 
 namespace Span
 {
-	Chunk::Chunk(uint32 capacity)
-		: Count(0), Capacity(capacity)
+	Chunk::Chunk(uint32 capacity, uint32 columnCount, size_t size)
+		: Size(size), Count(0), Capacity(capacity), ChangeVersions(columnCount), AddVersions(columnCount)
+		, EnabledBits(static_cast<size_t>(columnCount) * ((capacity + 63) / 64)), DisabledCounts(columnCount)
+		, MaskWords((capacity + 63) / 64)
 	{
-		// 16KBのメモリを確保
-		Memory = static_cast<uint8*>(std::malloc(CHUNK_SIZE));
+		// アーキタイプが選んだサイズのメモリをプールから確保
+		Memory = static_cast<uint8*>(ChunkAllocator::Allocate(size));
+
+		// 全て有効で開始
+		for (auto& word : EnabledBits) word.store(~0ull, std::memory_order_relaxed);
 	}
 
 	Chunk::~Chunk()
 	{
 		if (Memory)
 		{
-			std::free(Memory);
+			ChunkAllocator::Free(Memory);
 			Memory = nullptr;
 		}
 	}
@@ -33,6 +38,7 @@ namespace Span
 		{
 			size_t offset = arch->GetComponentOffset(typeID);
 			size_t size = arch->GetComponentSize(typeID);
+			if (size == 0) continue;
 
 			uint8* base = Memory + offset;
 			uint8* src = base + (srcIndex * size);
@@ -41,4 +47,36 @@ namespace Span
 			memcpy(dest, src, size);
 		}
 	}
+
+	bool Chunk::SetEnabled(uint32 column, uint32 index, bool enabled)
+	{
+		std::atomic<uint64>& word = EnabledBits[column * MaskWords + index / 64];
+		const uint64 bit = 1ull << (index % 64);
+
+		uint64 previous = enabled
+			? word.fetch_or(bit, std::memory_order_relaxed)
+			: word.fetch_and(~bit, std::memory_order_relaxed);
+
+		// 変化が無ければ何もしない
+		bool wasEnabled = (previous & bit) != 0;
+		if (wasEnabled == enabled) return false;
+
+		if (enabled) DisabledCounts[column].fetch_sub(1, std::memory_order_relaxed);
+		else DisabledCounts[column].fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	void Chunk::RemoveEnabledBits(uint32 index, uint32 lastIndex)
+	{
+		for (uint32 column = 0; column < static_cast<uint32>(DisabledCounts.size()); ++column)
+		{
+			if (!HasDisabled(column)) continue;
+
+			if (index != lastIndex)
+			{
+				SetEnabled(column, index, IsEnabled(column, lastIndex));
+			}
+			SetEnabled(column, lastIndex, true);
+		}
+	}
 }
@@ -11,17 +11,33 @@
 
 #pragma once
 #include "Core/CoreMinimal.h"
+#include "Core/Memory/ChunkAllocator.h"
 #include "Entity.h"
 
 namespace Span
 {
-	/// @brief		1つのチャンクが確保する固定メモリサイズ (16KB)
+	/// @brief		チャンクの既定 (最小) のメモリサイズ (16KB)
 	/// @details	L1/L2キャッシュへの適合率を高めるために設定されています。
-	constexpr size_t CHUNK_SIZE = 16 * 1024;
+	///				エンティティが大きいアーキタイプは、`ChunkAllocator::BLOCK_SIZES` のより大きなサイズを使用します。
+	constexpr size_t CHUNK_SIZE = ChunkAllocator::BLOCK_SIZE;
+
+#ifndef SPAN_MIN_ENTITIES_PER_CHUNK
+	/// @brief	1チャンクに格納したいエンティティ数の目標。これを下回るアーキタイプは、より大きなチャンクサイズを使用します。
+	#define SPAN_MIN_ENTITIES_PER_CHUNK 64
+#endif
+
+	/// @brief		1チャンクあたりの最小エンティティ数の目標
+	/// @details	1チャンクに数体しか入らないと、SoAの連続アクセスやチャンク単位の判定 (フィルター・有効ビット) の効果が失われるため、
+	///				最大のチャンクサイズ (256KB) に達するまでサイズを引き上げます。
+	constexpr uint32 MIN_ENTITIES_PER_CHUNK = SPAN_MIN_ENTITIES_PER_CHUNK;
+
+	/// @brief		コンポーネント配列 (列) の先頭アライメント
+	/// @details	キャッシュライン境界に揃え、AVX2/AVX-512のアラインドロード・ストアを使えるようにします。
+	constexpr size_t COLUMN_ALIGNMENT = 64;
 
 	/**
 	 * @struct	Chunk
-	 * @brief	🧱 コンポーネントデータを格納する固定サイズのメモリブロック。
+	 * @brief	🧱 コンポーネントデータを格納するメモリブロック (アーキタイプごとに 16KB / 64KB / 256KB)。
 	 * 
 	 * @details
 	 * Span EngineのECSにおけるメモリ割り当ての最小単位です。
@@ -33,12 +49,24 @@ namespace Span
 	 * | (N/A)  | `[ID][ID]...` | `[Data][Data]...` | `[Data][Data]...` | ... |
 	 * 
 	 * このSoA (Structure of Arrays) 配置により、SIMDによる並列処理やキャッシュプリフェッチが最適化されます。
+	 *
+	 * ### 🔁 変更バージョン (Change Version)
+	 * 列ごとに「最後に書き込まれたバージョン」を保持します。
+	 * `Changed<T>` / `Added<T>` フィルターは、これを見て変化の無いチャンクを丸ごとスキップします。
+	 *
+	 * ### 🔌 有効ビット (Enabled Bits)
+	 * 列ごとに1エンティティ1ビットの有効フラグを持ちます (`World::SetComponentEnabled`)。
+	 * 無効化されたコンポーネントはクエリの対象外になりますが、アーキタイプは変わりません。
+	 * `Count` 以降のスロットのビットは常に有効 (1) に保たれます。
 	 */
 	struct Chunk
 	{
-		/// @brief	生メモリブロック (16KB)
+		/// @brief	生メモリブロック (`ChunkAllocator` からページ境界に揃えて確保)
 		uint8* Memory = nullptr;
 
+		/// @brief	メモリブロックのサイズ (バイト)
+		size_t Size = 0;
+
 		/// @brief	現在格納されているEntity数
 		uint32 Count = 0;
 
@@ -48,9 +76,108 @@ namespace Span
 		/// @brief	所属するアーキタイプへのポインタ
 		class Archetype* OwnerArchetype = nullptr;
 
-		Chunk(uint32 capacity);
+		/// @brief	列 (コンポーネント配列) ごとの、最後に書き込まれたバージョン
+		std::vector<std::atomic<uint32>> ChangeVersions;
+
+		/// @brief	列ごとの、最後にコンポーネントが追加 (生成含む) されたバージョン
+		std::vector<std::atomic<uint32>> AddVersions;
+
+		/// @brief	有効ビット (列 * MaskWords + ワード番号、1ワード = 64エンティティ)
+		std::vector<std::atomic<uint64>> EnabledBits;
+
+		/// @brief	列ごとの無効化されているエンティティ数 (0なら有効ビットを見る必要が無い)
+		std::vector<std::atomic<uint32>> DisabledCounts;
+
+		/// @brief	1列あたりの有効ビットのワード数
+		uint32 MaskWords = 0;
+
+		/// @brief	共有コンポーネントの値の番号 (アーキタイプの `GetSharedTypes()` の順)
+		std::vector<uint32> SharedValues;
+
+		/**
+		 * @param	capacity 格納できる最大Entity数
+		 * @param	columnCount コンポーネントの種類数
+		 * @param	size メモリブロックのサイズ (`ChunkAllocator::BLOCK_SIZES` のいずれか)
+		 */
+		Chunk(uint32 capacity, uint32 columnCount, size_t size = CHUNK_SIZE);
 		~Chunk();
 
+		/// @brief	列が書き込まれたことを記録します。
+		void MarkChanged(uint32 column, uint32 version)
+		{
+			ChangeVersions[column].store(version, std::memory_order_relaxed);
+		}
+
+		/// @brief	全ての列が書き込まれたことを記録します (Entityの出入りなど)。
+		void MarkAllChanged(uint32 version)
+		{
+			for (auto& v : ChangeVersions) v.store(version, std::memory_order_relaxed);
+		}
+
+		/// @brief	列にコンポーネントが追加されたことを記録します (変更としても扱われます)。
+		void MarkAdded(uint32 column, uint32 version)
+		{
+			AddVersions[column].store(version, std::memory_order_relaxed);
+			ChangeVersions[column].store(version, std::memory_order_relaxed);
+		}
+
+		/// @brief	全ての列にコンポーネントが追加されたことを記録します (Entityの生成)。
+		void MarkAllAdded(uint32 version)
+		{
+			for (auto& v : AddVersions) v.store(version, std::memory_order_relaxed);
+			MarkAllChanged(version);
+		}
+
+		/// @brief	列が `sinceVersion` より後に書き込まれたか
+		bool DidChange(uint32 column, uint32 sinceVersion) const
+		{
+			return IsNewerVersion(ChangeVersions[column].load(std::memory_order_relaxed), sinceVersion);
+		}
+
+		/// @brief	列に `sinceVersion` より後にコンポーネントが追加されたか
+		bool DidAdd(uint32 column, uint32 sinceVersion) const
+		{
+			return IsNewerVersion(AddVersions[column].load(std::memory_order_relaxed), sinceVersion);
+		}
+
+		/// @brief	列に無効化されたエンティティが含まれるか
+		bool HasDisabled(uint32 column) const
+		{
+			return DisabledCounts[column].load(std::memory_order_relaxed) > 0;
+		}
+
+		/// @brief	エンティティのコンポーネントが有効か
+		bool IsEnabled(uint32 column, uint32 index) const
+		{
+			return (GetEnabledWord(column, index / 64) >> (index % 64)) & 1;
+		}
+
+		/// @brief	64エンティティ分の有効ビットを取得します。
+		uint64 GetEnabledWord(uint32 column, uint32 word) const
+		{
+			return EnabledBits[column * MaskWords + word].load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief	エンティティのコンポーネントの有効/無効を切り替えます。
+		 * @details	ビット操作はアトミックに行われるため、並列ジョブ内から呼び出しても安全です。
+		 * @return	状態が変化した場合は true
+		 */
+		bool SetEnabled(uint32 column, uint32 index, bool enabled);
+
+		/**
+		 * @brief	Swap-back削除に合わせて、末尾の有効ビットを削除位置へ移動します。
+		 * @param	index 削除される位置
+		 * @param	lastIndex 末尾の位置 (移動後は有効に戻されます)
+		 */
+		void RemoveEnabledBits(uint32 index, uint32 lastIndex);
+
+		/// @brief	周回 (オーバーフロー) を考慮したバージョン比較
+		static bool IsNewerVersion(uint32 version, uint32 sinceVersion)
+		{
+			return static_cast<int32>(version - sinceVersion) > 0;
+		}
+
 		/**
 		 * @brief	指定したオフセット位置にあるバッファの先頭アドレスを取得します。
 		 * @param	offset チャンク先頭からのバイトオフセット
@@ -0,0 +1,133 @@
+﻿/*****************************************************************//**
+ * @file	ChunkView.h
+ * @brief	チャンク単位の処理に渡される、コンポーネント配列へのビュー。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "Archetype.h"
+#include "SharedComponentStore.h"
+#include "System.h"
+
+namespace Span
+{
+	/**
+	 * @class	ChunkView
+	 * @brief	🔭 1つのチャンクの列 (コンポーネント配列) を `std::span` として公開します。
+	 *
+	 * @details
+	 * `World::ForEachChunk` から渡されます。各列の先頭は `COLUMN_ALIGNMENT` (64バイト) に揃っているため、
+	 * 配列をそのままSIMDのアラインドロード・ストアで処理できます。
+	 *
+	 * ### 🔌 無効化されたエンティティ
+	 * ビューには、コンポーネントが無効化されたエンティティも含まれます。
+	 * `HasDisabled()` が true の場合は、`GetEnabledMask` で有効なエンティティのビットを取得して除外してください。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * world.ForEachChunk<Transform, const Velocity>([](ChunkView view)
+	 * {
+	 *     std::span<Transform> transforms = view.GetColumn<Transform>();
+	 *     std::span<const Velocity> velocities = view.GetColumn<const Velocity>();
+	 *     for (uint32 i = 0; i < view.GetCount(); ++i) { ... }
+	 * });
+	 * ```
+	 */
+	class ChunkView
+	{
+	public:
+		/// @brief	64エンティティ分の有効ビットを取得する関数 (クエリの型リストごとに生成されます)
+		using EnabledMaskFunc = uint64(*)(const Chunk* chunk, const void* match, uint32 word);
+
+		/// @brief	クエリがコンポーネントの列へ書き込みアクセスするか判定する関数 (クエリの型リストごとに生成されます)
+		using WriteColumnFunc = bool(*)(ComponentTypeID typeID);
+
+		ChunkView(Chunk* chunk, const SharedComponentStore* sharedStore, bool hasDisabled, EnabledMaskFunc enabledMask, WriteColumnFunc isWriteColumn, const void* match)
+			: m_chunk(chunk), m_sharedStore(sharedStore), m_hasDisabled(hasDisabled), m_enabledMask(enabledMask), m_isWriteColumn(isWriteColumn), m_match(match)
+		{
+		}
+
+		/// @brief	チャンク内のエンティティ数
+		uint32 GetCount() const { return m_chunk->Count; }
+
+		/// @brief	エンティティIDの配列
+		std::span<const EntityID> GetEntityIDs() const
+		{
+			return std::span<const EntityID>(reinterpret_cast<const EntityID*>(m_chunk->Memory), m_chunk->Count);
+		}
+
+		/**
+		 * @brief	コンポーネントの配列を取得します。
+		 * @tparam	T コンポーネント型 (`const T` で読み取り専用)。クエリの型リストに含めた型を指定してください。
+		 * @return	`GetCount()` 個の要素を持つ配列。チャンクが `T` を持たない場合は空。
+		 * @note
+		 * 変更バージョンの記録とアクセス検証はクエリの型リストに対して行われるため、
+		 * 非constの `T` はクエリで書き込みアクセス (非const) として指定した型に限られます。
+		 */
+		template <typename T>
+		std::span<T> GetColumn() const
+		{
+			const Archetype* archetype = m_chunk->OwnerArchetype;
+			ComponentTypeID typeID = ComponentType<T>::GetID();
+#if SPAN_ECS_VALIDATE_ACCESS
+			if constexpr (!std::is_const_v<T>)
+			{
+				assert(m_isWriteColumn(typeID) && "ChunkView::GetColumn: non-const T must be a write term of the query (use const T to read)");
+			}
+#endif
+			if (!archetype->HasComponent(typeID)) return {};
+
+			T* column = reinterpret_cast<T*>(m_chunk->Memory + archetype->GetComponentOffset(typeID));
+			return std::span<T>(column, m_chunk->Count);
+		}
+
+		/// @brief	チャンクがコンポーネント `T` の列を持つか (`Optional<T>` の判定用)
+		template <typename T>
+		bool HasColumn() const
+		{
+			return m_chunk->OwnerArchetype->HasComponent(ComponentType<T>::GetID());
+		}
+
+		/**
+		 * @brief	共有コンポーネントの値を取得します。
+		 * @note	チャンクが `T` を持っていることを `Shared<T>` などでクエリ側で保証してください。
+		 */
+		template <typename T>
+		const T& GetShared() const
+		{
+			const Archetype* archetype = m_chunk->OwnerArchetype;
+			uint32 index = archetype->GetSharedIndex(ComponentType<Shared<T>>::GetID());
+			return m_sharedStore->Get<T>(m_chunk->SharedValues[index]);
+		}
+
+		/// @brief	クエリ対象の列に、無効化されたエンティティが含まれるか
+		bool HasDisabled() const { return m_hasDisabled; }
+
+		/**
+		 * @brief	クエリ対象の全列で有効なエンティティのビットを、64体分まとめて取得します。
+		 * @param	word ワード番号 (エンティティ番号 / 64)
+		 * @note	`GetCount()` 以降のビットは1になっている場合があります。
+		 */
+		uint64 GetEnabledMask(uint32 word) const
+		{
+			return m_hasDisabled ? m_enabledMask(m_chunk, m_match, word) : ~0ull;
+		}
+
+		/// @brief	元のチャンク
+		Chunk* GetChunk() const { return m_chunk; }
+
+	private:
+		Chunk* m_chunk;
+		const SharedComponentStore* m_sharedStore;
+		bool m_hasDisabled;
+		EnabledMaskFunc m_enabledMask;
+		WriteColumnFunc m_isWriteColumn;
+		const void* m_match;
+	};
+}
@@ -0,0 +1,142 @@
+﻿/*****************************************************************//**
+ * @file	ComponentLookup.h
+ * @brief	エンティティ参照を辿るためのコンポーネントのランダムアクセス。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "World.h"
+
+namespace Span
+{
+	/**
+	 * @class	ComponentLookup
+	 * @brief	🔗 Entityから特定のコンポーネントを繰り返し引くための参照テーブル。
+	 *
+	 * @details
+	 * 親子関係のように、他のエンティティへの参照を辿って `GetComponentPtr<T>` を何度も呼ぶ処理向けです。
+	 * アーキタイプごとの列のオフセットを `Update` 時にまとめて解決しておくため、
+	 * 1回の参照は「世代番号の確認 → 住所録 → オフセット表」の配列アクセスのみになります。
+	 * アクセス権の検証と変更バージョンの取得も `Update` 時に1回だけ行われます。
+	 *
+	 * - `ComponentLookup<const T>`: 読み取り専用。
+	 * - `ComponentLookup<T>`: 読み書き。取得したチャンクの `T` の列は変更扱いになります。
+	 *
+	 * `GetPtr` / `Has` は状態を書き換えないため、`ForEachParallel` のジョブ内から同時に呼び出せます
+	 * (読み書き版で同じエンティティへ複数のジョブから書き込まないことは、呼び出し側で保証してください)。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * class TransformSystem : public System
+	 * {
+	 *     ComponentLookup<const Relationship> m_relationships;
+	 *
+	 *     void OnCreate() override { m_relationships = ComponentLookup<const Relationship>(GetWorld()); }
+	 *     void OnUpdate() override
+	 *     {
+	 *         m_relationships.Update();	// システムの更新ごとに1回
+	 *         m_query.ForEachParallel([&](Entity e, ...) { const Relationship* rel = m_relationships.GetPtr(e); ... });
+	 *     }
+	 * };
+	 * ```
+	 *
+	 * @tparam	T 参照するコンポーネントの型 (`const T` で読み取り専用)
+	 */
+	template <typename T>
+	class ComponentLookup
+	{
+	public:
+		using ValueType = std::remove_const_t<T>;
+		static_assert(!ComponentType<ValueType>::IsTag, "ComponentLookup<T> requires a component with data. Use World::HasComponent for tags.");
+
+		ComponentLookup() = default;
+
+		/// @brief	作成時に `Update` を1回行います。
+		explicit ComponentLookup(World* world) : m_world(world) { Update(); }
+
+		/**
+		 * @brief	新しく生成されたアーキタイプのオフセットと、現在の変更バージョンを取り込みます。
+		 * @details	システムの `OnUpdate` ごとに、参照を始める前に呼び出してください (メインスレッドから)。
+		 */
+		void Update()
+		{
+			if (!m_world) return;
+
+			m_world->template ValidateAccess<T>();
+			m_writeVersion = m_world->GetWriteVersion();
+
+			// 既存のアーキタイプのオフセットは変わらないため、差分のみ解決する
+			const std::vector<Archetype*>& archetypes = m_world->archetypeManager.GetArchetypeList();
+			for (size_t i = m_columns.size(); i < archetypes.size(); ++i)
+			{
+				m_columns.push_back(Resolve(archetypes[i]));
+			}
+		}
+
+		/**
+		 * @brief	コンポーネントへのポインタを取得します。
+		 * @return	エンティティが破棄済み、またはコンポーネントを持っていない場合は `nullptr`
+		 */
+		T* GetPtr(Entity entity) const
+		{
+			const EntityLocation* loc = m_world->entityManager.GetLocation(entity);
+			if (!loc) return nullptr;
+
+			const Column column = GetColumn(loc->PtrArchetype);
+			if (column.Offset == NO_OFFSET) return nullptr;
+
+			// 書き込み目的の取得は変更として記録
+			if constexpr (!std::is_const_v<T>)
+			{
+				loc->PtrChunk->MarkChanged(column.Index, m_writeVersion);
+			}
+
+			return reinterpret_cast<T*>(loc->PtrChunk->Memory + column.Offset) + loc->IndexInChunk;
+		}
+
+		/**
+		 * @brief	エンティティが生存していて、コンポーネントを持っているか確認します。
+		 */
+		bool Has(Entity entity) const
+		{
+			const EntityLocation* loc = m_world->entityManager.GetLocation(entity);
+			return loc && GetColumn(loc->PtrArchetype).Offset != NO_OFFSET;
+		}
+
+	private:
+		/// @brief	コンポーネントを持たないアーキタイプを表すオフセット
+		static constexpr size_t NO_OFFSET = SIZE_MAX;
+
+		/// @brief	アーキタイプ内の `T` の列
+		struct Column
+		{
+			size_t Offset = NO_OFFSET;	///< チャンク先頭からのバイトオフセット
+			uint32 Index = 0;			///< 列番号 (変更バージョンの添字)
+		};
+
+		static Column Resolve(const Archetype* archetype)
+		{
+			const ComponentTypeID typeID = ComponentType<ValueType>::GetID();
+			if (!archetype->HasComponent(typeID)) return Column{};
+			return Column{ archetype->GetComponentOffset(typeID), archetype->GetColumnIndex(typeID) };
+		}
+
+		Column GetColumn(const Archetype* archetype) const
+		{
+			const uint32 index = archetype->GetIndex();
+
+			// Update 以降に生成されたアーキタイプは、その場で解決する
+			return (index < m_columns.size()) ? m_columns[index] : Resolve(archetype);
+		}
+
+	private:
+		World* m_world = nullptr;
+		std::vector<Column> m_columns;	///< アーキタイプの生成順 (`Archetype::GetIndex`) -> 列
+		uint32 m_writeVersion = 0;
+	};
+}
@@ -120,8 +120,8 @@ namespace std
 	{
 		std::size_t operator()(const Span::EntityID& id) const
 		{
-			// IndexとGenerationを混ぜてハッシュ値を作る
-			return hash<uint32_t>()(id.Index) ^ (hash<uint32_t>()(id.Generation) << 1);
+			// IndexとGenerationを64bitに詰めてからハッシュ化する (XORでは衝突が多いため)
+			return hash<uint64_t>()((static_cast<uint64_t>(id.Generation) << 32) | id.Index);
 		}
 	};
 }
@@ -81,6 +81,18 @@ namespace Span
 			return *this;
 		}
 
+		/**
+		 * @brief	共有コンポーネントの値を設定します。
+		 * @tparam	T 共有コンポーネント型
+		 * @param	value 設定する値
+		 */
+		template <typename T>
+		EntityBuilder& AddShared(const T& value)
+		{
+			m_world->SetSharedComponent<T>(m_entity, value);
+			return *this;
+		}
+
 		/**
 		 * @brief	特定のコンポーネントを操作
 		 */
@@ -0,0 +1,102 @@
+﻿#include "EntityCommandBuffer.h"
+#include "World.h"
+
+namespace Span
+{
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		Clear();
+
+		for (Page& page : pages)
+		{
+			std::free(page.Memory);
+		}
+		pages.clear();
+	}
+
+	void EntityCommandBuffer::DestroyEntity(Entity entity)
+	{
+		PushCommand([](World& world, Entity target, void*)
+		{
+			world.DestroyEntity(target);
+			return target;
+		}, nullptr, entity, nullptr);
+	}
+
+	void EntityCommandBuffer::Playback(World& world)
+	{
+		if (commands.empty()) return;
+
+		// 仮ハンドル -> 実際に生成されたEntity
+		std::vector<Entity> createdEntities(placeholderCount);
+
+		// 実行中に同じバッファへ記録されても破綻しないよう、インデックスで走査する
+		for (size_t i = 0; i < commands.size(); ++i)
+		{
+			Command cmd = commands[i];
+
+			if (cmd.IsCreate)
+			{
+				if (cmd.Target.ID.Index >= createdEntities.size()) createdEntities.resize(placeholderCount);
+				createdEntities[cmd.Target.ID.Index] = cmd.Apply(world, cmd.Target, nullptr);
+				continue;
+			}
+
+			// 仮ハンドルを実際に生成されたEntityへ置き換える
+			if (IsPlaceholder(cmd.Target))
+			{
+				uint32 index = cmd.Target.ID.Index;
+				if (index >= createdEntities.size()) continue;
+				cmd.Target = createdEntities[index];
+			}
+
+			cmd.Apply(world, cmd.Target, cmd.Payload);
+		}
+
+		Clear();
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		for (Command& cmd : commands)
+		{
+			if (cmd.Destroy) cmd.Destroy(cmd.Payload);
+		}
+		commands.clear();
+		placeholderCount = 0;
+
+		// ページは解放せず先頭から使い直す
+		currentPage = 0;
+		pageOffset = 0;
+	}
+
+	void* EntityCommandBuffer::AllocatePayload(size_t size, size_t alignment)
+	{
+		while (true)
+		{
+			if (currentPage < pages.size())
+			{
+				Page& page = pages[currentPage];
+
+				// アライメント調整後に収まれば確保完了
+				size_t address = reinterpret_cast<size_t>(page.Memory) + pageOffset;
+				size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+				if (pageOffset + padding + size <= page.Size)
+				{
+					void* memory = page.Memory + pageOffset + padding;
+					pageOffset += padding + size;
+					return memory;
+				}
+
+				// 収まらなければ次のページへ
+				++currentPage;
+				pageOffset = 0;
+				continue;
+			}
+
+			// ページが足りなければ追加 (大きな値は専用サイズで確保)
+			size_t pageSize = (std::max)(PAGE_SIZE, size + alignment);
+			pages.push_back({ static_cast<uint8*>(std::malloc(pageSize)), pageSize });
+		}
+	}
+}
@@ -0,0 +1,240 @@
+﻿/*****************************************************************//**
+ * @file	EntityCommandBuffer.h
+ * @brief	構造的変更を遅延実行するためのコマンドバッファ。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "Entity.h"
+
+namespace Span
+{
+	class World;
+
+	/**
+	 * @class	EntityCommandBuffer
+	 * @brief	📝 エンティティの生成・削除・コンポーネント操作を記録し、後でまとめて実行します。
+	 *
+	 * @details
+	 * `ForEach` の途中で `DestroyEntity` や `AddComponent` を呼ぶと、走査中のチャンクの
+	 * 要素数や並びが変わってしまいます。また、これらの操作はスレッドセーフではありません。
+	 * コマンドバッファに記録しておき、走査が終わった後 (同期ポイント) で `Playback` します。
+	 *
+	 * コマンドの引数 (コンポーネントの値) は、ページ単位で確保した領域に詰めて格納されます。
+	 * `Clear` 後もページは再利用されるため、毎フレーム使用してもメモリ確保は発生しません。
+	 *
+	 * ### 🧵 スレッド
+	 * 1つのバッファを複数スレッドから同時に使用することはできません。
+	 * 並列ジョブからは `World::GetCommandBuffer` でスレッド専用のバッファを取得してください。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * world.ForEachParallel<const Health>([&](Entity e, const Health& hp)
+	 * {
+	 *     if (hp.Value <= 0) world.GetCommandBuffer().DestroyEntity(e);
+	 * });
+	 * world.PlaybackCommandBuffers();	// システム内なら Wave 終了時に自動で実行されます
+	 * ```
+	 */
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer() = default;
+		~EntityCommandBuffer();
+
+		SPAN_NON_COPYABLE(EntityCommandBuffer);
+
+		// 🏭 Entity Commands
+		// ============================================================
+
+		/**
+		 * @brief	エンティティの生成を記録します。
+		 * @details
+		 * 戻り値は仮のハンドルです。同じバッファ内の後続コマンドの対象として使用でき、
+		 * `Playback` 時に実際のエンティティへ置き換えられます。
+		 * @return	仮のEntityハンドル (このバッファ内でのみ有効)
+		 */
+		template <typename... ComponentTypes>
+		Entity CreateEntity()
+		{
+			Entity placeholder{ { placeholderCount++, PLACEHOLDER_GENERATION } };
+			commands.push_back({ &ApplyCreate<ComponentTypes...>, nullptr, placeholder, nullptr, true });
+			return placeholder;
+		}
+
+		/// @brief	エンティティの削除を記録します。
+		void DestroyEntity(Entity entity);
+
+		// 🧩 Component Commands
+		// ============================================================
+
+		/**
+		 * @brief	コンポーネントの追加を記録します。
+		 * @param	entity 対象 (仮のハンドルも可)
+		 * @param	initialValue 初期値 (記録時にコピーされます)
+		 */
+		template <typename T>
+		void AddComponent(Entity entity, const T& initialValue = T())
+		{
+			PushCommand(&ApplyAdd<T>, &DestroyPayload<T>, entity, StorePayload(initialValue));
+		}
+
+		/// @brief	コンポーネントの削除を記録します。
+		template <typename T>
+		void RemoveComponent(Entity entity)
+		{
+			PushCommand(&ApplyRemove<T>, nullptr, entity, nullptr);
+		}
+
+		/**
+		 * @brief	コンポーネントの値の上書きを記録します。
+		 * @note	`Playback` 時点で対象がコンポーネントを持っていない場合はスキップされます。
+		 */
+		template <typename T>
+		void SetComponent(Entity entity, const T& value)
+		{
+			PushCommand(&ApplySet<T>, &DestroyPayload<T>, entity, StorePayload(value));
+		}
+
+		/// @brief	共有コンポーネントの値の設定を記録します。
+		template <typename T>
+		void SetSharedComponent(Entity entity, const T& value)
+		{
+			PushCommand(&ApplySetShared<T>, &DestroyPayload<T>, entity, StorePayload(value));
+		}
+
+		/// @brief	コンポーネントの有効/無効の切り替えを記録します。
+		template <typename T>
+		void SetComponentEnabled(Entity entity, bool enabled)
+		{
+			PushCommand(enabled ? &ApplyEnable<T, true> : &ApplyEnable<T, false>, nullptr, entity, nullptr);
+		}
+
+		// 🔄 Playback
+		// ============================================================
+
+		/**
+		 * @brief	記録された全てのコマンドを、記録順に実行してバッファを空にします。
+		 * @param	world 実行対象のワールド
+		 */
+		void Playback(World& world);
+
+		/// @brief	記録された全てのコマンドを破棄します (ページは再利用のため保持されます)。
+		void Clear();
+
+		/// @brief	コマンドが記録されていないか
+		bool IsEmpty() const { return commands.empty(); }
+
+		/// @brief	記録されているコマンド数
+		uint32 GetCommandCount() const { return static_cast<uint32>(commands.size()); }
+
+		/// @brief	仮のハンドルかどうか
+		static bool IsPlaceholder(Entity entity) { return entity.ID.Generation == PLACEHOLDER_GENERATION; }
+
+	private:
+		// 仮ハンドルの世代番号 (実際の世代番号はここまで到達しない)
+		static constexpr uint32 PLACEHOLDER_GENERATION = 0xFFFFFFFF;
+
+		// 引数格納用ページの既定サイズ
+		static constexpr size_t PAGE_SIZE = 16 * 1024;
+
+		/// @brief	コマンドの実行関数 (生成系は生成したEntity、それ以外は対象を返す)
+		using ApplyFunc = Entity(*)(World& world, Entity target, void* payload);
+
+		/// @brief	引数のデストラクタ呼び出し
+		using DestroyFunc = void(*)(void* payload);
+
+		struct Command
+		{
+			ApplyFunc Apply;
+			DestroyFunc Destroy;
+			Entity Target;
+			void* Payload;
+			bool IsCreate;		///< 生成コマンドか (Target は結果を書き込む仮ハンドル)
+		};
+
+		struct Page
+		{
+			uint8* Memory;
+			size_t Size;
+		};
+
+		void PushCommand(ApplyFunc apply, DestroyFunc destroy, Entity target, void* payload)
+		{
+			commands.push_back({ apply, destroy, target, payload, false });
+		}
+
+		template <typename T>
+		void* StorePayload(const T& value)
+		{
+			void* memory = AllocatePayload(sizeof(T), alignof(T));
+			new (memory) T(value);
+			return memory;
+		}
+
+		void* AllocatePayload(size_t size, size_t alignment);
+
+		// World はこの時点で不完全型のため、テンプレート引数にして実体化を利用側まで遅らせる
+		template <typename... ComponentTypes, typename W = World>
+		static Entity ApplyCreate(W& world, Entity, void*)
+		{
+			return world.template CreateEntity<ComponentTypes...>();
+		}
+
+		template <typename T, typename W = World>
+		static Entity ApplyAdd(W& world, Entity target, void* payload)
+		{
+			world.template AddComponent<T>(target, *static_cast<const T*>(payload));
+			return target;
+		}
+
+		template <typename T, typename W = World>
+		static Entity ApplyRemove(W& world, Entity target, void*)
+		{
+			world.template RemoveComponent<T>(target);
+			return target;
+		}
+
+		template <typename T, typename W = World>
+		static Entity ApplySet(W& world, Entity target, void* payload)
+		{
+			world.template SetComponent<T>(target, *static_cast<const T*>(payload));
+			return target;
+		}
+
+		template <typename T, typename W = World>
+		static Entity ApplySetShared(W& world, Entity target, void* payload)
+		{
+			world.template SetSharedComponent<T>(target, *static_cast<const T*>(payload));
+			return target;
+		}
+
+		template <typename T, bool Enabled, typename W = World>
+		static Entity ApplyEnable(W& world, Entity target, void*)
+		{
+			world.template SetComponentEnabled<T>(target, Enabled);
+			return target;
+		}
+
+		template <typename T>
+		static void DestroyPayload(void* payload)
+		{
+			static_cast<T*>(payload)->~T();
+		}
+
+	private:
+		std::vector<Command> commands;
+		uint32 placeholderCount = 0;
+
+		// 引数格納用のページ (Clear後も再利用する)
+		std::vector<Page> pages;
+		size_t currentPage = 0;
+		size_t pageOffset = 0;
+	};
+}
@@ -5,6 +5,7 @@ namespace Span
 	EntityManager::EntityManager()
 	{
 		generations.reserve(INITIAL_CAPACITY);
+		locations.reserve(INITIAL_CAPACITY);
 		freeIndices.reserve(INITIAL_CAPACITY);
 	}
 
@@ -23,6 +24,7 @@ namespace Span
 			// 2. 無ければ新規作成
 			idx = static_cast<uint32>(generations.size());
 			generations.push_back(0);
+			locations.emplace_back();
 		}
 
 		activeCount++;
@@ -31,6 +33,35 @@ namespace Span
 		return Entity{ { idx, generations[idx] } };
 	}
 
+	void EntityManager::CreateEntities(uint32 count, Entity* outEntities)
+	{
+		uint32 written = 0;
+
+		// 1. 再利用できるIDから先に使う
+		while (written < count && freeIndices.size() > MINIMUM_FREE_INDICES)
+		{
+			uint32 idx = freeIndices.back();
+			freeIndices.pop_back();
+			outEntities[written++] = Entity{ { idx, generations[idx] } };
+		}
+
+		// 2. 残りは世代配列を一括拡張して連番で発行
+		uint32 remaining = count - written;
+		if (remaining > 0)
+		{
+			uint32 firstIndex = static_cast<uint32>(generations.size());
+			generations.resize(generations.size() + remaining, 0);
+			locations.resize(generations.size());
+
+			for (uint32 i = 0; i < remaining; ++i)
+			{
+				outEntities[written++] = Entity{ { firstIndex + i, 0 } };
+			}
+		}
+
+		activeCount += count;
+	}
+
 	void EntityManager::DestroyEntity(Entity entity)
 	{
 		const uint32 idx = entity.ID.Index;
@@ -42,8 +73,9 @@ namespace Span
 			return;
 		}
 
-		// 世代を進める
+		// 世代を進め、住所を空にする
 		generations[idx]++;
+		locations[idx] = EntityLocation{};
 
 		// フリーリストに追加
 		freeIndices.push_back(idx);
@@ -61,4 +93,35 @@ namespace Span
 		// 2. 世代が一致しているか
 		return generations[entity.ID.Index] == entity.ID.Generation;
 	}
+
+	std::vector<Entity> EntityManager::GetAliveEntities() const
+	{
+		std::vector<Entity> entities;
+		entities.reserve(activeCount);
+
+		for (uint32 i = 0; i < static_cast<uint32>(locations.size()); ++i)
+		{
+			if (locations[i].PtrArchetype)
+			{
+				entities.push_back(Entity{ { i, generations[i] } });
+			}
+		}
+		return entities;
+	}
+
+	void EntityManager::SaveSnapshot(Snapshot& out) const
+	{
+		out.Generations = generations;
+		out.Locations = locations;
+		out.FreeIndices = freeIndices;
+		out.ActiveCount = activeCount;
+	}
+
+	void EntityManager::LoadSnapshot(const Snapshot& snapshot)
+	{
+		generations = snapshot.Generations;
+		locations = snapshot.Locations;
+		freeIndices = snapshot.FreeIndices;
+		activeCount = snapshot.ActiveCount;
+	}
 }
@@ -14,6 +14,24 @@
 
 namespace Span
 {
+	class Archetype;
+	struct Chunk;
+
+	/**
+	 * @struct	EntityLocation
+	 * @brief	📍 エンティティのデータ格納場所を示すポインタ。
+	 *
+	 * @details
+	 * エンティティIDから実際のコンポーネントデータへアクセスするための「住所」です。
+	 * これにより 0(1) でのコンポーネントアクセスが可能になります。
+	 */
+	struct EntityLocation
+	{
+		Archetype* PtrArchetype = nullptr;	///< 所属しているアーキタイプへのポインタ
+		Chunk* PtrChunk = nullptr;			///< データが格納されているチャンクへのポインタ
+		uint32 IndexInChunk = 0;			///< チャンク内でのインデックス (0 ~ ChunkCapacity)
+	};
+
 	/**
 	 * @class	EntityManager
 	 * @brief	🆔 Entity IDの発行、破棄、有効性チェックを行う管理クラス。
@@ -26,10 +44,25 @@ namespace Span
 	 * 1. **Create**: 空きインデックスがあれば再利用し、なければ新規発行。
 	 * 2. **Destroy**: 世代番号をインクリメントし、インデックスを空きリストへ返却。
 	 * 3. **IsAlive**: 現在の世代番号と、IDの世代番号が一致するかチェック。
+	 *
+	 * 各スロットの格納場所 (`EntityLocation`) も世代番号と同じインデックスの配列で保持するため、
+	 * IDからのコンポーネント参照はハッシュ計算の無い配列アクセス2回で完了します。
 	 */
 	class EntityManager
 	{
 	public:
+		/**
+		 * @struct	Snapshot
+		 * @brief	世代番号・住所録・空きリストの複製 (`World::Snapshot` 用)。
+		 */
+		struct Snapshot
+		{
+			std::vector<uint32> Generations;
+			std::vector<EntityLocation> Locations;
+			std::vector<uint32> FreeIndices;
+			size_t ActiveCount = 0;
+		};
+
 		EntityManager();
 		~EntityManager() = default;
 
@@ -38,6 +71,14 @@ namespace Span
 		/// @brief	新しいEntityを作成して返す
 		Entity CreateEntity();
 
+		/**
+		 * @brief	複数のEntityをまとめて作成します。
+		 * @details	再利用可能なIDを使い切った後は、世代配列をまとめて拡張して連番で発行します。
+		 * @param	count 作成数
+		 * @param	outEntities 結果の書き込み先 (count 個以上の領域)
+		 */
+		void CreateEntities(uint32 count, Entity* outEntities);
+
 		/// @brief	Entityを削除する
 		void DestroyEntity(Entity entity);
 
@@ -51,10 +92,51 @@ namespace Span
 		/// @brief	現在アクティブな (生きている) エンティティの総数
 		size_t GetActiveEntityCount() const { return activeCount; }
 
+		/**
+		 * @brief	生存しているEntityの格納場所を取得します。
+		 * @param	entity 対象のハンドル
+		 * @return	格納場所へのポインタ。破棄済みの場合は `nullptr`。
+		 */
+		EntityLocation* GetLocation(Entity entity)
+		{
+			const uint32 idx = entity.ID.Index;
+			if (idx >= generations.size() || generations[idx] != entity.ID.Generation) return nullptr;
+			return &locations[idx];
+		}
+
+		const EntityLocation* GetLocation(Entity entity) const
+		{
+			return const_cast<EntityManager*>(this)->GetLocation(entity);
+		}
+
+		/**
+		 * @brief	インデックスから格納場所を直接参照します (生存確認はしません)。
+		 * @details	チャンク内の移動など、生存が保証されているEntityの住所更新に使用します。
+		 */
+		EntityLocation& GetLocationByIndex(uint32 index) { return locations[index]; }
+
+		/// @brief	生存している全てのEntityをインデックス順に取得します。
+		std::vector<Entity> GetAliveEntities() const;
+
+		/**
+		 * @brief	ID管理の状態を丸ごと複製します。
+		 * @details	配列はまとめてコピーされ、`out` の既存の領域は再利用されます。
+		 */
+		void SaveSnapshot(Snapshot& out) const;
+
+		/**
+		 * @brief	`SaveSnapshot` で保存した状態に戻します。
+		 * @note	住所録のチャンクは保存時のポインタのままなので、呼び出し側で張り替えてください。
+		 */
+		void LoadSnapshot(const Snapshot& snapshot);
+
 	private:
 		// 各スロットの現在の世代番号を管理する配列
 		std::vector<uint32> generations;
 
+		// 各スロットの格納場所 (generations と同じインデックス、未使用スロットは PtrArchetype == nullptr)
+		std::vector<EntityLocation> locations;
+
 		// 再利用待ちのインデックスリスト
 		std::vector<uint32> freeIndices;
 
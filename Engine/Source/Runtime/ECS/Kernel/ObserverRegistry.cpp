@@ -0,0 +1,97 @@
+﻿#include "ObserverRegistry.h"
+#include "Archetype.h"
+
+namespace Span
+{
+	ObserverID ObserverRegistry::Add(ComponentTypeID typeID, ObserverEvent event, ObserverCallback callback)
+	{
+		if (typeID >= entries.size()) entries.resize(typeID + 1);
+		if (!entries[typeID]) entries[typeID] = std::make_unique<TypeEntry>();
+
+		if (std::find(observedTypes.begin(), observedTypes.end(), typeID) == observedTypes.end())
+		{
+			observedTypes.push_back(typeID);
+		}
+
+		const ObserverID id = nextID++;
+		entries[typeID]->Observers[static_cast<size_t>(event)].push_back({ id, std::move(callback) });
+		return id;
+	}
+
+	bool ObserverRegistry::Remove(ObserverID id)
+	{
+		for (ComponentTypeID typeID : observedTypes)
+		{
+			for (std::deque<Observer>& observers : entries[typeID]->Observers)
+			{
+				for (Observer& observer : observers)
+				{
+					if (observer.ID != id || !observer.IsActive) continue;
+
+					// 通知中は呼び出し中のコールバックを壊さないよう、印だけ付ける
+					observer.IsActive = false;
+					if (notifyDepth == 0) RemoveExpired();
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void ObserverRegistry::RecordObserved(const Archetype* from, const Archetype* to, std::span<const EntityID> ids)
+	{
+		for (ComponentTypeID typeID : observedTypes)
+		{
+			const bool had = from && from->HasComponent(typeID);
+			const bool has = to && to->HasComponent(typeID);
+			if (had == has) continue;
+
+			TypeEntry& entry = *entries[typeID];
+			const size_t event = static_cast<size_t>(has ? ObserverEvent::OnAdd : ObserverEvent::OnRemove);
+			if (entry.Observers[event].empty()) continue;
+
+			entry.Pending[event].insert(entry.Pending[event].end(), ids.begin(), ids.end());
+		}
+	}
+
+	void ObserverRegistry::TakePending(ComponentTypeID typeID, ObserverEvent event, std::vector<Entity>& out)
+	{
+		out.clear();
+		if (typeID >= entries.size() || !entries[typeID]) return;
+
+		// 取り出し先の領域を次の記録に回す
+		out.swap(entries[typeID]->Pending[static_cast<size_t>(event)]);
+	}
+
+	void ObserverRegistry::Notify(ComponentTypeID typeID, ObserverEvent event, World& world, std::span<const Entity> entities)
+	{
+		if (entities.empty()) return;
+
+		// コールバック内で登録が追加されても良いように、呼び出し前の数だけ添字で辿る
+		const std::deque<Observer>& observers = entries[typeID]->Observers[static_cast<size_t>(event)];
+		const size_t count = observers.size();
+
+		notifyDepth++;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (observers[i].IsActive) observers[i].Callback(world, entities);
+		}
+		notifyDepth--;
+
+		if (notifyDepth == 0) RemoveExpired();
+	}
+
+	void ObserverRegistry::RemoveExpired()
+	{
+		std::erase_if(observedTypes, [this](ComponentTypeID typeID)
+		{
+			TypeEntry& entry = *entries[typeID];
+			for (size_t event = 0; event < EVENT_COUNT; ++event)
+			{
+				std::erase_if(entry.Observers[event], [](const Observer& observer) { return !observer.IsActive; });
+				if (entry.Observers[event].empty()) entry.Pending[event].clear();
+			}
+			return entry.Observers[0].empty() && entry.Observers[1].empty();
+		});
+	}
+}
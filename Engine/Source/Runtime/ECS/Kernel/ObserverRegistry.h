@@ -0,0 +1,125 @@
+﻿/*****************************************************************//**
+ * @file	ObserverRegistry.h
+ * @brief	コンポーネントの追加・削除を監視するオブザーバーの登録先。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+#include "Entity.h"
+
+namespace Span
+{
+	class World;
+	class Archetype;
+
+	/// @brief	オブザーバーが監視するイベント
+	enum class ObserverEvent : uint8
+	{
+		OnAdd,		///< コンポーネントが追加された (生成・追加・ワールド間の移動)
+		OnRemove,	///< コンポーネントが削除された (削除・破棄・ワールド間の移動)
+	};
+
+	/// @brief	オブザーバーの登録番号 (`World::RemoveObserver` で使用)
+	using ObserverID = uint32;
+
+	/// @brief	`World::Observe` に渡すコールバック
+	using ObserverCallback = std::function<void(World&, std::span<const Entity>)>;
+
+	/**
+	 * @class	ObserverRegistry
+	 * @brief	👀 コンポーネント型ごとのオブザーバーと、通知待ちのエンティティを保持します。
+	 *
+	 * @details
+	 * 構造的変更のたびに、監視されている型が増減したエンティティを型ごとの配列に追記するだけで、
+	 * コールバックは呼び出しません。通知は `World::FlushObservers` (同期ポイント) でまとめて行われます。
+	 * オブザーバーが1つも無い間は、記録は分岐1つで終わります。
+	 */
+	class ObserverRegistry
+	{
+	public:
+		ObserverRegistry() = default;
+		~ObserverRegistry() = default;
+
+		SPAN_NON_COPYABLE(ObserverRegistry);
+
+		/**
+		 * @brief	オブザーバーを登録します。
+		 * @param	typeID 監視するコンポーネントの型ID
+		 * @param	event 監視するイベント
+		 * @param	callback 通知先
+		 * @return	登録番号
+		 */
+		ObserverID Add(ComponentTypeID typeID, ObserverEvent event, ObserverCallback callback);
+
+		/**
+		 * @brief	オブザーバーの登録を解除します。
+		 * @return	登録されていた場合は true
+		 */
+		bool Remove(ObserverID id);
+
+		/**
+		 * @brief	アーキタイプ間の移動で増減した、監視対象の型を記録します。
+		 * @param	from 移動元 (生成の場合は nullptr)
+		 * @param	to 移動先 (破棄の場合は nullptr)
+		 * @param	ids 移動したエンティティ
+		 */
+		void Record(const Archetype* from, const Archetype* to, std::span<const EntityID> ids)
+		{
+			if (observedTypes.empty()) return;
+			RecordObserved(from, to, ids);
+		}
+
+		/// @brief	オブザーバーが登録されている型の一覧 (登録順)
+		const std::vector<ComponentTypeID>& GetObservedTypes() const { return observedTypes; }
+
+		/**
+		 * @brief	通知待ちのエンティティを取り出します (記録は空になります)。
+		 * @param	out 取り出し先 (以前の内容は破棄されます)
+		 */
+		void TakePending(ComponentTypeID typeID, ObserverEvent event, std::vector<Entity>& out);
+
+		/**
+		 * @brief	型とイベントに登録されている全てのオブザーバーを呼び出します。
+		 * @details	コールバック内でのオブザーバーの登録・解除や構造的変更に対応しています (変更は次回の通知に反映されます)。
+		 */
+		void Notify(ComponentTypeID typeID, ObserverEvent event, World& world, std::span<const Entity> entities);
+
+	private:
+		static constexpr size_t EVENT_COUNT = 2;
+
+		struct Observer
+		{
+			ObserverID ID;
+			ObserverCallback Callback;
+			bool IsActive = true;	///< 解除済みは false (通知中でなければ取り除く)
+		};
+
+		/**
+		 * @brief	型1つ分のオブザーバーと通知待ちのエンティティ
+		 * @details	通知中に登録が追加されても呼び出し中のコールバックが移動しないよう、オブザーバーは `std::deque` に保持します。
+		 */
+		struct TypeEntry
+		{
+			std::deque<Observer> Observers[EVENT_COUNT];
+			std::vector<Entity> Pending[EVENT_COUNT];
+		};
+
+		void RecordObserved(const Archetype* from, const Archetype* to, std::span<const EntityID> ids);
+
+		/// @brief	解除済みのオブザーバーを取り除き、監視されなくなった型を一覧から外します。
+		void RemoveExpired();
+
+	private:
+		std::vector<std::unique_ptr<TypeEntry>> entries;	///< 型ID -> オブザーバー
+		std::vector<ComponentTypeID> observedTypes;			///< オブザーバーが1つ以上ある型
+		ObserverID nextID = 1;
+		uint32 notifyDepth = 0;								///< 通知中 (コールバック内) の深さ
+	};
+}
@@ -0,0 +1,172 @@
+﻿/*****************************************************************//**
+ * @file	Query.h
+ * @brief	システムが保持する永続クエリオブジェクト。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "World.h"
+
+namespace Span
+{
+	/**
+	 * @class	Query
+	 * @brief	🔎 一致するアーキタイプをキャッシュし、繰り返し実行するためのクエリ。
+	 *
+	 * @details
+	 * `World::ForEach` と同じ条件でエンティティを走査しますが、
+	 * 一致したアーキタイプとコンポーネントのオフセットをオブジェクト自身が保持します。
+	 * アーキタイプが新しく生成された場合のみ、その差分だけを検査してキャッシュを更新します。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * class MoveSystem : public System
+	 * {
+	 *     Query<Transform, const Velocity> m_query;
+	 *
+	 *     void OnCreate() override { m_query = Query<Transform, const Velocity>(GetWorld()); }
+	 *     void OnUpdate() override
+	 *     {
+	 *         m_query.ForEach([](Entity e, Transform& t, const Velocity& v) { ... });
+	 *     }
+	 * };
+	 * ```
+	 *
+	 * @tparam	ComponentTypes 要求するコンポーネントの型リスト (`const T` で読み取り専用、`Changed<T>` 等でフィルター)
+	 */
+	template <typename... ComponentTypes>
+	class Query
+	{
+	public:
+		Query() = default;
+		explicit Query(World* world) : m_world(world) {}
+
+		/**
+		 * @brief	一致する全てのエンティティに対して関数を実行します。
+		 * @param	func `[](Entity e, ComponentTypes&... comps) { ... }`
+		 */
+		template <typename Func>
+		void ForEach(Func&& func)
+		{
+			if (!m_world) return;
+
+			m_world->template ValidateQueryAccess<ComponentTypes...>();
+			m_world->template IterateQuery<ComponentTypes...>(Update(), m_world->template MakeEntityProcessor<ComponentTypes...>(func));
+		}
+
+		/**
+		 * @brief	`ForEach` の並列版。詳細は `World::ForEachParallel` を参照してください。
+		 * @param	func 実行するラムダ式 (複数スレッドから同時に呼ばれます)
+		 * @param	minBatchSize 1ジョブあたりの最小エンティティ数
+		 */
+		template <typename Func>
+		void ForEachParallel(Func&& func, uint32 minBatchSize = World::DEFAULT_PARALLEL_BATCH_SIZE)
+		{
+			if (!m_world) return;
+
+			m_world->template ValidateQueryAccess<ComponentTypes...>();
+			m_world->template IterateQueryParallel<ComponentTypes...>(Update(), m_world->template MakeEntityProcessor<ComponentTypes...>(func), minBatchSize);
+		}
+
+		/**
+		 * @brief	一致するチャンクごとに関数を実行します。詳細は `World::ForEachChunk` を参照してください。
+		 * @param	func `[](ChunkView view) { ... }`
+		 */
+		template <typename Func>
+		void ForEachChunk(Func&& func)
+		{
+			if (!m_world) return;
+
+			m_world->template ValidateQueryAccess<ComponentTypes...>();
+			m_world->template IterateQuery<ComponentTypes...>(Update(), m_world->template MakeChunkProcessor<ComponentTypes...>(func));
+		}
+
+		/**
+		 * @brief	`ForEachChunk` の並列版。
+		 * @param	func `[](ChunkView view) { ... }` (複数スレッドから同時に呼ばれます)
+		 * @param	minBatchSize 1ジョブあたりの最小エンティティ数
+		 */
+		template <typename Func>
+		void ForEachChunkParallel(Func&& func, uint32 minBatchSize = World::DEFAULT_PARALLEL_BATCH_SIZE)
+		{
+			if (!m_world) return;
+
+			m_world->template ValidateQueryAccess<ComponentTypes...>();
+			m_world->template IterateQueryParallel<ComponentTypes...>(Update(), m_world->template MakeChunkProcessor<ComponentTypes...>(func), minBatchSize);
+		}
+
+		/**
+		 * @brief	一致するエンティティの総数を計算します。
+		 * @details	`Changed<T>` などのフィルターを含む場合、条件を満たすチャンクのエンティティのみを数えます。
+		 *			無効化されたコンポーネントを持つエンティティは数えません。
+		 * @return	エンティティ数
+		 */
+		uint32 CalculateEntityCount()
+		{
+			if (!m_world) return 0;
+
+			const uint32 filterVersion = m_world->GetFilterVersion();
+
+			uint32 count = 0;
+			for (const auto& match : Update().Matches)
+			{
+				for (Chunk* chunk : match.PtrArchetype->GetChunks())
+				{
+					if (QueryState<ComponentTypes...>::PassesFilters(chunk, match, filterVersion))
+					{
+						count += QueryState<ComponentTypes...>::CountEnabled(chunk, match);
+					}
+				}
+			}
+			return count;
+		}
+
+		/**
+		 * @brief	一致するエンティティが1つも無いか判定します。
+		 * @details	`CalculateEntityCount` と異なり、最初に見つかった時点で終了します。
+		 */
+		bool IsEmpty()
+		{
+			if (!m_world) return true;
+
+			const uint32 filterVersion = m_world->GetFilterVersion();
+			for (const auto& match : Update().Matches)
+			{
+				for (Chunk* chunk : match.PtrArchetype->GetChunks())
+				{
+					if (chunk->Count > 0 && QueryState<ComponentTypes...>::PassesFilters(chunk, match, filterVersion)
+						&& QueryState<ComponentTypes...>::CountEnabled(chunk, match) > 0)
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * @brief	一致するアーキタイプの一覧を取得します (キャッシュは最新化されます)。
+		 */
+		const auto& GetMatches() { return Update().Matches; }
+
+		/// @brief	対象のワールド
+		World* GetWorld() const { return m_world; }
+
+	private:
+		/// @brief	新しく生成されたアーキタイプの差分を取り込みます。
+		QueryState<ComponentTypes...>& Update()
+		{
+			m_state.Update(m_world->archetypeManager);
+			return m_state;
+		}
+
+	private:
+		World* m_world = nullptr;
+		QueryState<ComponentTypes...> m_state;
+	};
+}
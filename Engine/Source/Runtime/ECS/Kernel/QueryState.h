@@ -0,0 +1,261 @@
+﻿/*****************************************************************//**
+ * @file	QueryState.h
+ * @brief	クエリに一致するアーキタイプのキャッシュ。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ArchetypeManager.h"
+#include "QueryTerm.h"
+
+namespace Span
+{
+	/**
+	 * @struct	QueryStateBase
+	 * @brief	型消去してキャッシュに格納するための基底。
+	 */
+	struct QueryStateBase
+	{
+		/// @brief	列を持たない項目 (`Without<T>` や、`Optional<T>` で持っていない場合など) の列番号
+		static constexpr uint32 INVALID_COLUMN = 0xFFFFFFFF;
+
+		virtual ~QueryStateBase() = default;
+
+		/// @brief	前回以降に生成されたアーキタイプを検査し、一致するものを追加します。
+		virtual void Update(const ArchetypeManager& manager) = 0;
+	};
+
+	/**
+	 * @struct	QueryState
+	 * @brief	🗂️ 条件に一致したアーキタイプと、各コンポーネント配列のオフセットを保持します。
+	 *
+	 * @details
+	 * アーキタイプは一度生成されると削除されないため、`ArchetypeManager` の生成順リストのうち
+	 * 前回 `Update` 以降に追加された分だけを検査すれば、キャッシュを最新に保てます。
+	 * 新しいアーキタイプが生成されていなければ、`Update` は比較1回で終わります。
+	 *
+	 * アーキタイプの判定は、型リストから作った必須・除外の署名マスクとの比較 (ワードごとのAND) で行います。
+	 *
+	 * @tparam	ComponentTypes 要求するコンポーネントの型リスト (`Changed<T>` などのフィルターを含む)
+	 */
+	template <typename... ComponentTypes>
+	struct QueryState : public QueryStateBase
+	{
+		/// @brief	コンポーネントごとのチャンク内オフセット
+		using OffsetTuple = std::tuple<decltype(sizeof(ComponentTypes))...>;
+
+		/// @brief	コンポーネントごとの列番号 (変更バージョンの参照用、`Shared<T>` は共有コンポーネントの番号、列が無ければ `INVALID_COLUMN`)
+		using ColumnArray = std::array<uint32, sizeof...(ComponentTypes)>;
+
+		/// @brief	一致したアーキタイプ1つ分の情報
+		struct Match
+		{
+			Archetype* PtrArchetype;
+			OffsetTuple Offsets;
+			ColumnArray Columns;
+		};
+
+		/// @brief	`Changed<T>` / `Added<T>` を含むか
+		static constexpr bool HasFilters = ((QueryTerm<ComponentTypes>::IsChangeFilter || QueryTerm<ComponentTypes>::IsAddFilter) || ...);
+
+		/// @brief	書き込みアクセスを含むか
+		static constexpr bool HasWrites = (QueryTerm<ComponentTypes>::IsWrite || ...);
+
+		/// @brief	項目ごとの、有効ビットを判定に使うかどうか (共有・任意・除外の項目は使わない)
+		static constexpr std::array<bool, sizeof...(ComponentTypes)> EnabledTerms = { (QueryTerm<ComponentTypes>::HasColumn && !QueryTerm<ComponentTypes>::IsOptional)... };
+
+		std::vector<Match> Matches;		///< 一致したアーキタイプ (生成順)
+		size_t ProcessedArchetypes = 0;	///< 検査済みのアーキタイプ数
+
+		/**
+		 * @brief	前回以降に生成されたアーキタイプを検査し、一致するものを追加します。
+		 * @param	manager 検査対象のアーキタイプ管理
+		 */
+		void Update(const ArchetypeManager& manager) override
+		{
+			const std::vector<Archetype*>& list = manager.GetArchetypeList();
+			if (ProcessedArchetypes == list.size()) return;
+
+			const Masks& masks = GetMasks();
+			for (size_t i = ProcessedArchetypes; i < list.size(); ++i)
+			{
+				Archetype* arch = list[i];
+				const ArchetypeSignature& signature = arch->GetSignature();
+				if (signature.Contains(masks.Required) && !signature.Intersects(masks.Excluded) &&
+					(QueryTerm<ComponentTypes>::MatchArchetype(signature) && ...))
+				{
+					Matches.push_back({ arch,
+						std::make_tuple(GetTermOffset<ComponentTypes>(arch)...),
+						ColumnArray{ GetTermColumn<ComponentTypes>(arch)... } });
+				}
+			}
+
+			ProcessedArchetypes = list.size();
+		}
+
+		/**
+		 * @brief	チャンクがフィルター条件を満たすか判定します (フィルター無しなら常に true)。
+		 * @param	chunk 判定するチャンク
+		 * @param	match チャンクが属するアーキタイプの一致情報
+		 * @param	sinceVersion この値より新しい変更のみを対象にする
+		 */
+		static bool PassesFilters(const Chunk* chunk, const Match& match, uint32 sinceVersion)
+		{
+			if constexpr (!HasFilters)
+			{
+				return true;
+			}
+			else
+			{
+				return [&]<size_t... Indices>(std::index_sequence<Indices...>)
+				{
+					return (PassesTerm<ComponentTypes>(chunk, match.Columns[Indices], sinceVersion) || ...);
+				}(std::index_sequence_for<ComponentTypes...>{});
+			}
+		}
+
+		/**
+		 * @brief	書き込みアクセスする列に、チャンクの変更バージョンを記録します。
+		 * @param	chunk 処理するチャンク
+		 * @param	match チャンクが属するアーキタイプの一致情報
+		 * @param	version 記録するバージョン
+		 */
+		static void MarkWrites(Chunk* chunk, const Match& match, uint32 version)
+		{
+			if constexpr (HasWrites)
+			{
+				[&]<size_t... Indices>(std::index_sequence<Indices...>)
+				{
+					((QueryTerm<ComponentTypes>::IsWrite && match.Columns[Indices] != INVALID_COLUMN ? chunk->MarkChanged(match.Columns[Indices], version) : void()), ...);
+				}(std::index_sequence_for<ComponentTypes...>{});
+			}
+		}
+
+		/// @brief	コンポーネント `typeID` の列へ書き込みアクセスする項目があるか (`ChunkView::GetColumn` の検証用)
+		static bool IsWriteColumn(ComponentTypeID typeID)
+		{
+			return ((QueryTerm<ComponentTypes>::IsWrite && QueryTerm<ComponentTypes>::HasColumn &&
+				ComponentType<typename QueryTerm<ComponentTypes>::AccessType>::GetID() == typeID) || ...);
+		}
+
+		/// @brief	対象の列のいずれかに、無効化されたエンティティが含まれるか
+		static bool HasDisabled(const Chunk* chunk, const Match& match)
+		{
+			for (size_t i = 0; i < match.Columns.size(); ++i)
+			{
+				if (EnabledTerms[i] && chunk->HasDisabled(match.Columns[i])) return true;
+			}
+			return false;
+		}
+
+		/**
+		 * @brief	全ての対象列で有効なエンティティのビットを、64体分まとめて取得します。
+		 * @param	word ワード番号 (エンティティ番号 / 64)
+		 */
+		static uint64 GetEnabledWord(const Chunk* chunk, const Match& match, uint32 word)
+		{
+			uint64 bits = ~0ull;
+			for (size_t i = 0; i < match.Columns.size(); ++i)
+			{
+				if (EnabledTerms[i]) bits &= chunk->GetEnabledWord(match.Columns[i], word);
+			}
+			return bits;
+		}
+
+		/// @brief	チャンク内で、全ての対象列が有効なエンティティ数を数えます。
+		static uint32 CountEnabled(const Chunk* chunk, const Match& match)
+		{
+			if (!HasDisabled(chunk, match)) return chunk->Count;
+
+			uint32 count = 0;
+			const uint32 wordCount = (chunk->Count + 63) / 64;
+			for (uint32 word = 0; word < wordCount; ++word)
+			{
+				uint64 bits = GetEnabledWord(chunk, match, word);
+				uint32 remaining = chunk->Count - word * 64;
+				if (remaining < 64) bits &= (1ull << remaining) - 1;
+				count += static_cast<uint32>(std::popcount(bits));
+			}
+			return count;
+		}
+
+	private:
+		/// @brief	アーキタイプの署名が満たすべき条件
+		struct Masks
+		{
+			ArchetypeSignature Required;	///< 全て持っている必要があるコンポーネント
+			ArchetypeSignature Excluded;	///< 1つも持っていてはならないコンポーネント
+		};
+
+		static const Masks& GetMasks()
+		{
+			static const Masks masks = []
+			{
+				Masks result;
+				(QueryTerm<ComponentTypes>::AddToMasks(result.Required, result.Excluded), ...);
+				return result;
+			}();
+			return masks;
+		}
+
+		template <typename Term>
+		static ComponentTypeID GetTermID()
+		{
+			return ComponentType<typename QueryTerm<Term>::AccessType>::GetID();
+		}
+
+		template <typename Term>
+		static uint32 GetTermColumn(const Archetype* arch)
+		{
+			if constexpr (QueryTerm<Term>::IsShared)
+			{
+				return arch->GetSharedIndex(GetTermID<Term>());
+			}
+			else if constexpr (QueryTerm<Term>::HasColumn)
+			{
+				ComponentTypeID id = GetTermID<Term>();
+				return arch->HasComponent(id) ? arch->GetColumnIndex(id) : INVALID_COLUMN;
+			}
+			else
+			{
+				return INVALID_COLUMN;
+			}
+		}
+
+		template <typename Term>
+		static size_t GetTermOffset(const Archetype* arch)
+		{
+			if constexpr (QueryTerm<Term>::HasColumn)
+			{
+				return arch->GetComponentOffset(GetTermID<Term>());
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template <typename Term>
+		static bool PassesTerm(const Chunk* chunk, uint32 column, uint32 sinceVersion)
+		{
+			if constexpr (QueryTerm<Term>::IsChangeFilter)
+			{
+				return chunk->DidChange(column, sinceVersion);
+			}
+			else if constexpr (QueryTerm<Term>::IsAddFilter)
+			{
+				return chunk->DidAdd(column, sinceVersion);
+			}
+			else
+			{
+				return false;
+			}
+		}
+	};
+}
@@ -0,0 +1,189 @@
+﻿/*****************************************************************//**
+ * @file	QueryTerm.h
+ * @brief	クエリの型リストに指定できるフィルター項目。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+
+namespace Span
+{
+	/**
+	 * @struct	Changed
+	 * @brief	🔁 前回のシステム実行以降に `T` が書き込まれたチャンクのみを対象にするフィルター。
+	 *
+	 * @details
+	 * 関数には通常どおり `T&` (`Changed<const T>` なら `const T&`) が渡されます。
+	 * 判定はチャンク単位のため、同じチャンク内の変更されていないエンティティも含まれます。
+	 * 複数のフィルターを指定した場合は、いずれかを満たすチャンクが対象になります。
+	 *
+	 * ```cpp
+	 * world.ForEach<Changed<const Transform>, LocalToWorld>([](Entity e, const Transform& t, LocalToWorld& ltw) { ... });
+	 * ```
+	 */
+	template <typename T>
+	struct Changed {};
+
+	/**
+	 * @struct	Added
+	 * @brief	🆕 前回のシステム実行以降に `T` が追加 (エンティティ生成を含む) されたチャンクのみを対象にするフィルター。
+	 */
+	template <typename T>
+	struct Added {};
+
+	/**
+	 * @struct	Shared
+	 * @brief	🤝 チャンク単位で値を共有する共有コンポーネント `T` を要求する項目。
+	 *
+	 * @details
+	 * 共有コンポーネントは `World::SetSharedComponent` で設定し、値はエンティティごとではなくチャンクに1つだけ保持されます。
+	 * 関数には `const T&` が渡され、同じチャンク内の全エンティティで同じ値を指します。
+	 * システムのアクセス宣言では `DeclareRead<Shared<T>>()` のように指定します。
+	 *
+	 * ```cpp
+	 * world.ForEach<Shared<RenderMaterial>, const LocalToWorld>([](Entity e, const RenderMaterial& mat, const LocalToWorld& ltw) { ... });
+	 * ```
+	 */
+	template <typename T>
+	struct Shared {};
+
+	/**
+	 * @struct	With
+	 * @brief	✅ `T` を持つアーキタイプのみを対象にする項目 (関数には渡されません)。
+	 * @details	無効化された `T` を持つエンティティは対象外になります。
+	 */
+	template <typename T>
+	struct With {};
+
+	/**
+	 * @struct	Without
+	 * @brief	🚫 `T` を持たないアーキタイプのみを対象にする項目 (関数には渡されません)。
+	 *
+	 * ```cpp
+	 * world.ForEach<Transform, Without<Relationship>>([](Entity e, Transform& t) { ... });
+	 * ```
+	 */
+	template <typename T>
+	struct Without {};
+
+	/**
+	 * @struct	Optional
+	 * @brief	❔ `T` を持っていれば対象にし、関数には `T*` (持っていなければ `nullptr`) を渡す項目。
+	 * @details	有無はアーキタイプ単位で決まるため、有効/無効の状態は考慮されません。
+	 */
+	template <typename T>
+	struct Optional {};
+
+	/**
+	 * @struct	Any
+	 * @brief	🔀 列挙した型のいずれかを持つアーキタイプのみを対象にする項目 (関数には渡されません)。
+	 */
+	template <typename... Ts>
+	struct Any {};
+
+	/**
+	 * @struct	QueryTerm
+	 * @brief	クエリの型リストの1項目を解釈するための特性クラス。
+	 *
+	 * @details
+	 * 各項目は `AddToMasks` で、アーキタイプの署名が満たすべき条件を必須・除外のビットマスクに書き込みます。
+	 * マスクで表せない条件 (`Any<Ts...>`) だけは `MatchArchetype` で個別に判定します。
+	 * 判定はクエリのキャッシュ更新時にアーキタイプごとに1回だけ行われ、エンティティごとのループには影響しません。
+	 *
+	 * @tparam	T `Transform`, `const Transform`, `Changed<Transform>` など
+	 */
+	template <typename T>
+	struct QueryTerm
+	{
+		/// @brief	チャンク上のコンポーネント型 (const修飾を含む、関数に渡さない項目は `void`)
+		using Component = T;
+
+		/// @brief	型IDの解決とアクセス検証に使用する型
+		using AccessType = T;
+
+		static constexpr bool IsWrite = !std::is_const_v<T>;	///< 書き込みアクセスか
+		static constexpr bool IsChangeFilter = false;			///< `Changed<T>` か
+		static constexpr bool IsAddFilter = false;				///< `Added<T>` か
+		static constexpr bool IsShared = false;					///< `Shared<T>` か
+		static constexpr bool IsOptional = false;				///< `Optional<T>` か
+		static constexpr bool HasColumn = true;					///< チャンク内の列を参照するか
+		static constexpr bool HasArgument = true;				///< 関数の引数として渡されるか
+
+		/// @brief	必須 (`required`)・除外 (`excluded`) のマスクにこの項目の条件を書き込みます
+		template <typename Signature>
+		static void AddToMasks(Signature& required, Signature&) { required.Add(ComponentType<T>::GetID()); }
+
+		/// @brief	マスクで表せない条件を満たすか
+		template <typename Signature>
+		static bool MatchArchetype(const Signature&) { return true; }
+	};
+
+	template <typename T>
+	struct QueryTerm<Changed<T>> : QueryTerm<T>
+	{
+		static_assert(QueryTerm<T>::HasArgument && QueryTerm<T>::HasColumn && !QueryTerm<T>::IsOptional, "Changed<T> requires a plain component type");
+		static constexpr bool IsChangeFilter = true;
+	};
+
+	template <typename T>
+	struct QueryTerm<Added<T>> : QueryTerm<T>
+	{
+		static_assert(QueryTerm<T>::HasArgument && QueryTerm<T>::HasColumn && !QueryTerm<T>::IsOptional, "Added<T> requires a plain component type");
+		static constexpr bool IsAddFilter = true;
+	};
+
+	template <typename T>
+	struct QueryTerm<Shared<T>> : QueryTerm<const Shared<std::remove_const_t<T>>>
+	{
+		using Component = const std::remove_const_t<T>;
+
+		static constexpr bool IsShared = true;
+		static constexpr bool HasColumn = false;
+	};
+
+	template <typename T>
+	struct QueryTerm<With<T>> : QueryTerm<const std::remove_const_t<T>>
+	{
+		using Component = void;
+
+		static constexpr bool HasArgument = false;
+	};
+
+	template <typename T>
+	struct QueryTerm<Optional<T>> : QueryTerm<T>
+	{
+		static constexpr bool IsOptional = true;
+
+		template <typename Signature>
+		static void AddToMasks(Signature&, Signature&) {}
+	};
+
+	template <typename T>
+	struct QueryTerm<Without<T>> : QueryTerm<With<T>>
+	{
+		static constexpr bool HasColumn = false;
+
+		template <typename Signature>
+		static void AddToMasks(Signature&, Signature& excluded) { excluded.Add(ComponentType<T>::GetID()); }
+	};
+
+	template <typename... Ts>
+	struct QueryTerm<Any<Ts...>> : QueryTerm<With<std::tuple_element_t<0, std::tuple<Ts...>>>>
+	{
+		static_assert(sizeof...(Ts) > 0, "Any<> requires at least one type");
+		static constexpr bool HasColumn = false;
+
+		template <typename Signature>
+		static void AddToMasks(Signature&, Signature&) {}
+
+		template <typename Signature>
+		static bool MatchArchetype(const Signature& signature) { return (signature.Has(ComponentType<Ts>::GetID()) || ...); }
+	};
+}
@@ -0,0 +1,184 @@
+﻿/*****************************************************************//**
+ * @file	ResourceStore.h
+ * @brief	ワールドに1つだけ存在するデータ (リソース) のストア。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+
+namespace Span
+{
+	/**
+	 * @struct	Resource
+	 * @brief	🌐 リソース `T` へのアクセスをシステムに宣言するための項目。
+	 *
+	 * @details
+	 * リソースはコンポーネントと同じ `SystemAccess` で扱われるため、
+	 * 同じリソースを書き込むシステムと読み取るシステムは並列に実行されません。
+	 *
+	 * ```cpp
+	 * void OnCreate() override
+	 * {
+	 *     DeclareRead<Resource<ActiveCamera>>();
+	 *     DeclareWrite<LocalToWorld>();
+	 * }
+	 * ```
+	 */
+	template <typename T>
+	struct Resource {};
+
+	/**
+	 * @class	ResourceStore
+	 * @brief	🌐 型ごとに1つの値を保持し、型IDの配列で直接引けるようにします。
+	 *
+	 * @details
+	 * 値は `ComponentType<Resource<T>>::GetID()` を添字とした配列に、型ごとに個別に確保されます。
+	 * 配列は生成時に全ての型ID分を確保するため、リソースの追加で配列自体が再確保されることはありません。
+	 * (別の型のリソースを宣言したシステム同士は並列に実行されるため、各スロットは宣言したシステムだけが触れます)
+	 * 各値は最後に書き込まれた時の変更バージョンを持ちます (チャンクの列と同じバージョン)。
+	 */
+	class ResourceStore
+	{
+	public:
+		ResourceStore() : slots(MAX_COMPONENT_TYPES) {}
+		~ResourceStore() = default;
+
+		SPAN_NON_COPYABLE(ResourceStore);
+
+		/**
+		 * @brief	値を設定します (既にあれば上書きします)。
+		 * @param	value 設定する値
+		 * @param	version 変更バージョン
+		 * @return	格納された値への参照
+		 */
+		template <typename T>
+		T& Set(T&& value, uint32 version)
+		{
+			using ValueType = std::remove_cvref_t<T>;
+			const ComponentTypeID resourceID = ComponentType<Resource<ValueType>>::GetID();
+			assert(resourceID < slots.size() && "ResourceStore: slots must be sized up front");
+
+			if (slots[resourceID])
+			{
+				static_cast<Slot<ValueType>&>(*slots[resourceID]).Value = std::forward<T>(value);
+			}
+			else
+			{
+				slots[resourceID] = std::make_unique<Slot<ValueType>>(std::forward<T>(value));
+			}
+
+			slots[resourceID]->ChangedVersion = version;
+			return static_cast<Slot<ValueType>&>(*slots[resourceID]).Value;
+		}
+
+		/**
+		 * @brief	値を削除します。
+		 * @return	値があった場合は true
+		 */
+		template <typename T>
+		bool Remove()
+		{
+			const ComponentTypeID resourceID = ComponentType<Resource<T>>::GetID();
+			if (resourceID >= slots.size() || !slots[resourceID]) return false;
+
+			slots[resourceID].reset();
+			return true;
+		}
+
+		/**
+		 * @brief	値へのポインタを取得します。
+		 * @return	設定されていない場合は `nullptr`
+		 */
+		template <typename T>
+		T* Find() const
+		{
+			const ComponentTypeID resourceID = ComponentType<Resource<T>>::GetID();
+			if (resourceID >= slots.size() || !slots[resourceID]) return nullptr;
+
+			return &static_cast<Slot<T>&>(*slots[resourceID]).Value;
+		}
+
+		/**
+		 * @brief	値が最後に書き込まれた時の変更バージョンを取得します。
+		 * @return	設定されていない場合は 0
+		 */
+		template <typename T>
+		uint32 GetChangedVersion() const
+		{
+			const ComponentTypeID resourceID = ComponentType<Resource<T>>::GetID();
+			if (resourceID >= slots.size() || !slots[resourceID]) return 0;
+
+			return slots[resourceID]->ChangedVersion;
+		}
+
+		/// @brief	値を書き込んだものとして変更バージョンを更新します。
+		template <typename T>
+		void MarkChanged(uint32 version)
+		{
+			const ComponentTypeID resourceID = ComponentType<Resource<T>>::GetID();
+			if (resourceID < slots.size() && slots[resourceID]) slots[resourceID]->ChangedVersion = version;
+		}
+
+		/**
+		 * @brief	別のストアの全ての値を複製し、全て変更扱いにします。
+		 * @details	`World::Snapshot` / `Restore` で使用します。
+		 */
+		void CopyFrom(const ResourceStore& other, uint32 version)
+		{
+			slots.clear();
+			slots.resize(MAX_COMPONENT_TYPES);
+			for (size_t i = 0; i < other.slots.size(); ++i)
+			{
+				if (!other.slots[i]) continue;
+
+				slots[i] = other.slots[i]->Clone();
+				slots[i]->ChangedVersion = version;
+			}
+		}
+
+	private:
+		struct SlotBase
+		{
+			virtual ~SlotBase() = default;
+
+			/// @brief	値を含めて複製する
+			virtual std::unique_ptr<SlotBase> Clone() const = 0;
+
+			uint32 ChangedVersion = 0;
+		};
+
+		template <typename T>
+		struct Slot : SlotBase
+		{
+			template <typename U>
+			explicit Slot(U&& value) : Value(std::forward<U>(value)) {}
+			Slot() = default;
+
+			std::unique_ptr<SlotBase> Clone() const override
+			{
+				if constexpr (std::is_copy_constructible_v<T>)
+				{
+					return std::make_unique<Slot<T>>(Value);
+				}
+				else
+				{
+					// コピーできない型 (ムーブ専用など) は既定値で複製する
+					SPAN_WARN("ResourceStore: '%s' is not copy constructible. Snapshot stores a default value.", typeid(T).name());
+					return std::make_unique<Slot<T>>();
+				}
+			}
+
+			T Value;
+		};
+
+	private:
+		std::vector<std::unique_ptr<SlotBase>> slots;	///< `Resource<T>` の型ID -> 値 (常に `MAX_COMPONENT_TYPES` 要素)
+	};
+}
@@ -0,0 +1,249 @@
+﻿/*****************************************************************//**
+ * @file	SharedComponentStore.h
+ * @brief	共有コンポーネントの値を保持するストア。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+#include "QueryTerm.h"
+#include <optional>
+
+namespace Span
+{
+	/**
+	 * @class	SharedComponentStore
+	 * @brief	🤝 共有コンポーネントの値を型ごとに重複なく保持し、番号で引けるようにします。
+	 *
+	 * @details
+	 * 同じ値 (`operator==` で比較) は1つにまとめられ、同じ番号が返ります。
+	 * 既存の値はハッシュ値からの索引で探すため、登録のコストは値の種類数に依存しません。
+	 * ハッシュには `std::hash<T>` を使用します (特殊化が無い場合、パディングを含まない型はバイト列から計算します)。
+	 * チャンクはこの番号を保持し、番号の組み合わせが同じエンティティだけを同じチャンクに格納します。
+	 *
+	 * 値はエンティティ単位で参照カウントされ、参照が無くなった値は破棄され、スロットは次の値に再利用されます。
+	 * 値の格納先は `std::deque` のため、新しい値を追加しても既存の値の参照は無効になりません。
+	 */
+	class SharedComponentStore
+	{
+	public:
+		/// @brief	値が未設定であることを表す番号
+		static constexpr uint32 INVALID_INDEX = 0xFFFFFFFF;
+
+		SharedComponentStore() = default;
+		~SharedComponentStore() = default;
+
+		SPAN_NON_COPYABLE(SharedComponentStore);
+
+		/**
+		 * @brief	値を登録 (既に同じ値があればそれを参照) し、参照カウントを1増やします。
+		 * @return	値の番号
+		 */
+		template <typename T>
+		uint32 Acquire(const T& value)
+		{
+			return GetPool<T>().Acquire(value, 1);
+		}
+
+		/**
+		 * @brief	別のストアの値をこのストアへ登録し、参照カウントを `count` 増やします (ワールド間の移動用)。
+		 * @param	source 値を持っているストア
+		 * @param	sharedID `ComponentType<Shared<T>>::GetID()`
+		 * @param	sourceIndex `source` での値の番号
+		 * @param	count 増やす参照カウント (移動するエンティティ数)
+		 * @return	このストアでの値の番号
+		 */
+		uint32 AcquireFrom(const SharedComponentStore& source, ComponentTypeID sharedID, uint32 sourceIndex, uint32 count)
+		{
+			const PoolBase& sourcePool = *source.pools[sharedID];
+			if (sharedID >= pools.size()) pools.resize(sharedID + 1);
+			if (!pools[sharedID]) pools[sharedID] = sourcePool.CreateEmpty();
+			return pools[sharedID]->AcquireFrom(sourcePool, sourceIndex, count);
+		}
+
+		/**
+		 * @brief	参照カウントを減らします。0になった値は破棄されます。
+		 * @param	sharedID `ComponentType<Shared<T>>::GetID()`
+		 * @param	index 値の番号
+		 * @param	count 減らす参照カウント
+		 */
+		void Release(ComponentTypeID sharedID, uint32 index, uint32 count = 1)
+		{
+			if (sharedID >= pools.size() || !pools[sharedID]) return;
+			pools[sharedID]->Release(index, count);
+		}
+
+		/**
+		 * @brief	別のストアの全ての値と参照カウントを複製します (値の番号も同じになります)。
+		 * @details	`World::Snapshot` / `Restore` で使用します。
+		 */
+		void CopyFrom(const SharedComponentStore& other)
+		{
+			pools.clear();
+			pools.resize(other.pools.size());
+			for (size_t i = 0; i < other.pools.size(); ++i)
+			{
+				if (other.pools[i]) pools[i] = other.pools[i]->Clone();
+			}
+		}
+
+		/// @brief	番号から値を取得します。
+		template <typename T>
+		const T& Get(uint32 index) const
+		{
+			return *static_cast<const Pool<T>&>(*pools[ComponentType<Shared<T>>::GetID()]).Values[index];
+		}
+
+		/// @brief	現在参照されている値の種類数を取得します。
+		template <typename T>
+		uint32 GetValueCount() const
+		{
+			ComponentTypeID sharedID = ComponentType<Shared<T>>::GetID();
+			if (sharedID >= pools.size() || !pools[sharedID]) return 0;
+
+			const PoolBase& pool = *pools[sharedID];
+			return static_cast<uint32>(pool.RefCounts.size() - pool.FreeSlots.size());
+		}
+
+	private:
+		struct PoolBase
+		{
+			virtual ~PoolBase() = default;
+
+			/// @brief	値を破棄して索引から外し、オブジェクトが保持するリソースを手放す
+			virtual void ResetValue(uint32 index) = 0;
+
+			/// @brief	同じ型の空のプールを作成する
+			virtual std::unique_ptr<PoolBase> CreateEmpty() const = 0;
+
+			/// @brief	値と参照カウントを含めて複製する
+			virtual std::unique_ptr<PoolBase> Clone() const = 0;
+
+			/// @brief	同じ型の別のプールの値を登録する
+			virtual uint32 AcquireFrom(const PoolBase& source, uint32 sourceIndex, uint32 count) = 0;
+
+			void Release(uint32 index, uint32 count)
+			{
+				if (index >= RefCounts.size() || RefCounts[index] == 0) return;
+
+				RefCounts[index] -= (std::min)(count, RefCounts[index]);
+				if (RefCounts[index] == 0)
+				{
+					ResetValue(index);
+					FreeSlots.push_back(index);
+				}
+			}
+
+			std::vector<uint32> RefCounts;
+			std::vector<uint32> FreeSlots;
+		};
+
+		template <typename T>
+		struct Pool : PoolBase
+		{
+			void ResetValue(uint32 index) override
+			{
+				auto [first, last] = Index.equal_range(HashValue(*Values[index]));
+				for (auto it = first; it != last; ++it)
+				{
+					if (it->second == index)
+					{
+						Index.erase(it);
+						break;
+					}
+				}
+				Values[index].reset();
+			}
+
+			std::unique_ptr<PoolBase> CreateEmpty() const override { return std::make_unique<Pool<T>>(); }
+
+			std::unique_ptr<PoolBase> Clone() const override { return std::make_unique<Pool<T>>(*this); }
+
+			uint32 AcquireFrom(const PoolBase& source, uint32 sourceIndex, uint32 count) override
+			{
+				return Acquire(*static_cast<const Pool<T>&>(source).Values[sourceIndex], count);
+			}
+
+			uint32 Acquire(const T& value, uint32 count)
+			{
+				// 既存の値を索引から探す (同じハッシュ値の値だけを比較する)
+				const size_t hash = HashValue(value);
+				auto [first, last] = Index.equal_range(hash);
+				for (auto it = first; it != last; ++it)
+				{
+					if (*Values[it->second] == value)
+					{
+						RefCounts[it->second] += count;
+						return it->second;
+					}
+				}
+
+				// 空きスロットを再利用、無ければ末尾に追加
+				uint32 index;
+				if (!FreeSlots.empty())
+				{
+					index = FreeSlots.back();
+					FreeSlots.pop_back();
+					Values[index].emplace(value);
+				}
+				else
+				{
+					index = static_cast<uint32>(Values.size());
+					Values.emplace_back(value);
+					RefCounts.push_back(0);
+				}
+
+				RefCounts[index] = count;
+				Index.emplace(hash, index);
+				return index;
+			}
+
+			std::deque<std::optional<T>> Values;			///< 参照の無いスロットは空
+			std::unordered_multimap<size_t, uint32> Index;	///< 値のハッシュ値 -> スロット (参照のある値のみ)
+		};
+
+		/// @brief	索引用のハッシュ値を計算します。
+		template <typename T>
+		static size_t HashValue(const T& value)
+		{
+			if constexpr (std::is_default_constructible_v<std::hash<T>>)
+			{
+				return std::hash<T>{}(value);
+			}
+			else
+			{
+				// パディングを含む型はバイト列が値と一致しないため、std::hash<T> の特殊化が必要
+				static_assert(std::has_unique_object_representations_v<T>,
+					"Shared component types need a std::hash<T> specialization (or a layout without padding bytes)");
+
+				// FNV-1a
+				const auto* bytes = reinterpret_cast<const uint8*>(&value);
+				uint64 hash = 0xcbf29ce484222325ull;
+				for (size_t i = 0; i < sizeof(T); ++i)
+				{
+					hash ^= bytes[i];
+					hash *= 0x100000001b3ull;
+				}
+				return static_cast<size_t>(hash);
+			}
+		}
+
+		template <typename T>
+		Pool<T>& GetPool()
+		{
+			ComponentTypeID sharedID = ComponentType<Shared<T>>::GetID();
+			if (sharedID >= pools.size()) pools.resize(sharedID + 1);
+			if (!pools[sharedID]) pools[sharedID] = std::make_unique<Pool<T>>();
+			return static_cast<Pool<T>&>(*pools[sharedID]);
+		}
+
+	private:
+		std::vector<std::unique_ptr<PoolBase>> pools;	///< 共有コンポーネントの型ID -> 値の配列
+	};
+}
@@ -11,11 +11,78 @@
 
 #pragma once
 #include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+
+/// @brief	宣言外のコンポーネントアクセスを検出するデバッグ検証 (Debugビルドで既定有効)
+#if !defined(SPAN_ECS_VALIDATE_ACCESS)
+	#if defined(_DEBUG)
+		#define SPAN_ECS_VALIDATE_ACCESS 1
+	#else
+		#define SPAN_ECS_VALIDATE_ACCESS 0
+	#endif
+#endif
 
 namespace Span
 {
 	class World;
 
+	/**
+	 * @struct	SystemAccess
+	 * @brief	📋 システムが読み書きするコンポーネントの宣言。
+	 *
+	 * @details
+	 * `World` はこの宣言を元に依存関係 (DAG) を構築し、競合しないシステム同士を並列に実行します。
+	 * 何も宣言していないシステムは「全てにアクセスする」とみなされ、メインスレッドで単独実行されます。
+	 *
+	 * | A \ B     | Read  | Write |
+	 * | :---      | :---: | :---: |
+	 * | **Read**  | 並列可 | 競合 |
+	 * | **Write** | 競合  | 競合 |
+	 */
+	struct SystemAccess
+	{
+		std::vector<ComponentTypeID> Reads;		///< 読み取るコンポーネント
+		std::vector<ComponentTypeID> Writes;	///< 書き込むコンポーネント
+		bool IsDeclared = false;				///< アクセス宣言が行われたか (false = 排他実行)
+
+		/// @brief	読み取りが許可されているか (書き込み宣言は読み取りも含みます)
+		bool CanRead(ComponentTypeID typeID) const
+		{
+			return Contains(Reads, typeID) || Contains(Writes, typeID);
+		}
+
+		/// @brief	書き込みが許可されているか
+		bool CanWrite(ComponentTypeID typeID) const
+		{
+			return Contains(Writes, typeID);
+		}
+
+		/**
+		 * @brief	他のシステムと同時に実行できないか判定します。
+		 * @retval	true 競合あり (順番に実行する必要がある)
+		 */
+		bool ConflictsWith(const SystemAccess& other) const
+		{
+			if (!IsDeclared || !other.IsDeclared) return true;
+
+			for (ComponentTypeID id : Writes)
+			{
+				if (other.CanRead(id)) return true;
+			}
+			for (ComponentTypeID id : other.Writes)
+			{
+				if (Contains(Reads, id)) return true;
+			}
+			return false;
+		}
+
+	private:
+		static bool Contains(const std::vector<ComponentTypeID>& list, ComponentTypeID typeID)
+		{
+			return std::find(list.begin(), list.end(), typeID) != list.end();
+		}
+	};
+
 	/**
 	 * @class	System
 	 * @brief	🧠 ゲームロジックを実装するための基底クラス。
@@ -28,6 +95,19 @@ namespace Span
 	 * 1. **OnCreate**: システム生成時、最初に1回だけ呼ばれます。
 	 * 2. **OnUpdate**: 毎フレーム呼ばれます。メインロジックはここに記述します。
 	 * 3. **OnDestroy**: ワールド破棄時やシステム削除時に呼ばれます。
+	 *
+	 * ### 🧵 並列実行
+	 * `OnCreate` 内で `DeclareRead` / `DeclareWrite` を呼び出してアクセスするコンポーネントを宣言すると、
+	 * 競合しない他のシステムとワーカースレッド上で同時に実行されるようになります。
+	 * 宣言したシステムの `OnUpdate` では、構造的変更 (Create/Destroy/Add/Remove) やレンダラー等の
+	 * スレッド非安全なAPIの呼び出しを行わないでください。
+	 * ```cpp
+	 * void OnCreate() override
+	 * {
+	 *     DeclareRead<Transform, Relationship>();
+	 *     DeclareWrite<LocalToWorld>();
+	 * }
+	 * ```
 	 */
 	class System
 	{
@@ -64,7 +144,41 @@ namespace Span
 		/// @brief	システムの有効/無効を切り替えます。
 		void SetEnabled(bool enabled) { isEnabled = enabled; }
 
+		/// @brief	宣言されたコンポーネントアクセス
+		const SystemAccess& GetAccess() const { return access; }
+
+		/// @brief	デバッグ表示用のシステム名
+		const char* GetName() const { return typeid(*this).name(); }
+
+		/**
+		 * @brief	前回 `OnUpdate` を実行した時の変更バージョン
+		 * @details	`Changed<T>` / `Added<T>` フィルターは、これより新しい変更のあるチャンクのみを対象にします。
+		 */
+		uint32 GetLastRunVersion() const { return lastRunVersion; }
+
 	protected:
+		/**
+		 * @brief	読み取り専用でアクセスするコンポーネントを宣言します。
+		 * @tparam	ComponentTypes コンポーネント型リスト
+		 */
+		template <typename... ComponentTypes>
+		void DeclareRead()
+		{
+			access.IsDeclared = true;
+			(access.Reads.push_back(ComponentType<ComponentTypes>::GetID()), ...);
+		}
+
+		/**
+		 * @brief	書き込みを行うコンポーネントを宣言します。
+		 * @tparam	ComponentTypes コンポーネント型リスト
+		 */
+		template <typename... ComponentTypes>
+		void DeclareWrite()
+		{
+			access.IsDeclared = true;
+			(access.Writes.push_back(ComponentType<ComponentTypes>::GetID()), ...);
+		}
+
 		/**
 		 * @brief	所属しているワールドを取得します。
 		 * @return	ワールドへのポインタ
@@ -72,8 +186,14 @@ namespace Span
 		World* GetWorld() const { return m_world; }
 
 	private:
+		friend class World;
+
 		World* m_world = nullptr;
 		bool isEnabled = true;
+		SystemAccess access;
+
+		uint32 currentVersion = 0;	///< 実行中の変更バージョン (書き込んだ列に記録される)
+		uint32 lastRunVersion = 0;	///< 前回実行時の変更バージョン
 	};
 }
 
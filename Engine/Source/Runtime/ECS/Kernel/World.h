@@ -5,6 +5,7 @@
  * @details
  * エンティティの生成、コンポーネントの操作、システム実行の統括を行います。
  * 通常、1つのシーンにつき1つのWorldインスタンスが存在します。
+ * 読み込み用の別のWorldで構築したエンティティは、`MoveEntitiesFrom` でまとめて合流できます。
  *
  * ------------------------------------------------------------
  * @author	Iwai Shogo
@@ -13,27 +14,21 @@
 
 #pragma once
 #include "Core/CoreMinimal.h"
+#include "Core/Jobs/JobSystem.h"
 #include "EntityManager.h"
 #include "ArchetypeManager.h"
+#include "QueryState.h"
+#include "SharedComponentStore.h"
+#include "ResourceStore.h"
+#include "ObserverRegistry.h"
+#include "ChunkView.h"
+#include "WorldSnapshot.h"
+#include "WorldStats.h"
+#include "EntityCommandBuffer.h"
 #include "System.h"
 
 namespace Span
 {
-	/**
-	 * @struct	EntityLocation
-	 * @brief	📍 エンティティのデータ格納場所を示すポインタ。
-	 *
-	 * @details
-	 * エンティティIDから実際のコンポーネントデータへアクセスするための「住所」です。
-	 * これにより 0(1) でのコンポーネントアクセスが可能になります。
-	 */
-	struct EntityLocation
-	{
-		Archetype* PtrArchetype;	///< 所属しているアーキタイプへのポインタ
-		Chunk* PtrChunk;			///< データが格納されているチャンクへのポインタ
-		uint32 IndexInChunk;		///< チャンク内でのインデックス (0 ~ ChunkCapacity)
-	};
-
 	/**
 	 * @struct	World
 	 * @brief	🌏 ECSの管理マネージャー。全てのEntityとSystemを保持します。
@@ -50,7 +45,7 @@ namespace Span
 	 * ### 🔄 メモリフロー (Memory Flow)
 	 * 1. `CreateEntity` でエンティティを生成
 	 * 2. コンポーネント構成に基づいて適切な `Archetype` が選択される。
-	 * 3. その中の `Chunk` (16KBブロック) にメモリが確保され、データが配置される。
+	 * 3. その中の `Chunk` (16KB〜256KBのブロック) にメモリが確保され、データが配置される。
 	 */
 	class World
 	{
@@ -76,6 +71,8 @@ namespace Span
 		template <typename... ComponentTypes>
 		Entity CreateEntity()
 		{
+			ValidateStructuralChange("CreateEntity");
+
 			// 1. IDを発行
 			Entity entity = entityManager.CreateEntity();
 
@@ -83,17 +80,98 @@ namespace Span
 			Archetype* archetype = archetypeManager.GetOrCreateArchetype<ComponentTypes...>();
 
 			// 3. アーキタイプ内のチャンクに場所を確保
-			uint32 index = archetype->AllocateEntity(entity.ID);
-			Chunk* chunk = archetype->GetChunks().back();
+			uint32 index = 0;
+			Chunk* chunk = archetype->AllocateEntity(entity.ID, index);
 
 			// 4. コンポーネントの初期化
-			EntityLocation loc{ archetype, chunk, index };
-			entityLocationMap[entity.ID] = loc;
+			EntityLocation& loc = entityManager.GetLocationByIndex(entity.ID.Index);
+			loc = EntityLocation{ archetype, chunk, index };
 
 			InitializeComponents<ComponentTypes...>(loc);
+			chunk->MarkAllAdded(GetWriteVersion());
+			observers.Record(nullptr, archetype, std::span<const EntityID>(&entity.ID, 1));
 			return entity;
 		}
 
+		/**
+		 * @brief	同じコンポーネント構成のエンティティをまとめて作成します。
+		 *
+		 * @details
+		 * IDを一括で発行し、チャンクを容量いっぱいまで一度に埋めます。
+		 * コンポーネントは1つずつではなく、配列 (カラム) 単位でまとめて初期化されます。
+		 * @tparam	ComponentTypes 初期状態で持たせるコンポーネントのリスト
+		 * @param	count 作成数
+		 * @param	outEntities 作成されたEntityの書き込み先 (不要なら空、必要なら count 個以上)
+		 *
+		 * @code	{.cpp}
+		 * std::vector<Entity> bullets(10000);
+		 * world.CreateEntities<Transform, Velocity>(10000, bullets);
+		 * @endcode
+		 */
+		template <typename... ComponentTypes>
+		void CreateEntities(uint32 count, std::span<Entity> outEntities = {})
+		{
+			CreateEntities<ComponentTypes...>(count, outEntities, [](std::span<const Entity>, std::span<ComponentTypes>...) {});
+		}
+
+		/**
+		 * @brief	エンティティをまとめて作成し、チャンク単位で初期化関数を呼び出します。
+		 * @param	count 作成数
+		 * @param	outEntities 作成されたEntityの書き込み先 (不要なら空、必要なら count 個以上)
+		 * @param	init `[](std::span<const Entity> entities, std::span<ComponentTypes>... columns) { ... }`
+		 *
+		 * @code	{.cpp}
+		 * world.CreateEntities<Transform, Velocity>(10000, {}, [&](std::span<const Entity> entities, std::span<Transform> transforms, std::span<Velocity> velocities)
+		 * {
+		 *     for (size_t i = 0; i < entities.size(); ++i) transforms[i].Position = spawnPoint;
+		 * });
+		 * @endcode
+		 */
+		template <typename... ComponentTypes, typename InitFunc>
+		void CreateEntities(uint32 count, std::span<Entity> outEntities, InitFunc&& init)
+		{
+			if (count == 0) return;
+			ValidateStructuralChange("CreateEntities");
+
+			// 1. IDを一括発行 (出力先が無ければ一時領域へ)
+			std::vector<Entity> scratch;
+			Entity* entities = outEntities.data();
+			if (outEntities.size() < count)
+			{
+				scratch.resize(count);
+				entities = scratch.data();
+			}
+			entityManager.CreateEntities(count, entities);
+
+			// 2. 適切なアーキタイプを取得
+			Archetype* archetype = archetypeManager.GetOrCreateArchetype<ComponentTypes...>();
+
+			// 3. チャンクの空きを埋められるだけ確保し、カラム単位で初期化
+			const uint32 version = GetWriteVersion();
+			uint32 created = 0;
+			while (created < count)
+			{
+				uint32 startIndex = 0;
+				uint32 batchCount = 0;
+				Chunk* chunk = archetype->AllocateRange(count - created, startIndex, batchCount);
+
+				const Entity* batch = entities + created;
+				EntityID* ids = reinterpret_cast<EntityID*>(chunk->Memory) + startIndex;
+				for (uint32 i = 0; i < batchCount; ++i)
+				{
+					ids[i] = batch[i].ID;
+					entityManager.GetLocationByIndex(batch[i].ID.Index) = EntityLocation{ archetype, chunk, startIndex + i };
+				}
+
+				init(std::span<const Entity>(batch, batchCount),
+					InitializeColumn<ComponentTypes>(archetype, chunk, startIndex, batchCount)...);
+				chunk->MarkAllAdded(version);
+				observers.Record(nullptr, archetype, std::span<const EntityID>(ids, batchCount));
+
+				created += batchCount;
+			}
+		}
+
 		/**
 		 * @brief	エンティティを削除します。
 		 * @param	entity 削除対象
@@ -104,34 +182,26 @@ namespace Span
 		 */
 		void DestroyEntity(Entity entity)
 		{
-			if (!IsAlive(entity)) return;
-
-			auto it = entityLocationMap.find(entity.ID);
-			if (it == entityLocationMap.end()) return;
+			const EntityLocation* found = entityManager.GetLocation(entity);
+			if (!found) return;
+			ValidateStructuralChange("DestroyEntity");
 
-			EntityLocation loc = it->second;
-			Chunk* chunk = loc.PtrChunk;
+			EntityLocation loc = *found;
+			observers.Record(loc.PtrArchetype, nullptr, std::span<const EntityID>(&entity.ID, 1));
 
-			// アーキタイプから削除 (Swap-back removal)
-			uint32 lastIndex = chunk->Count - 1;
-			EntityID lastEntityID = reinterpret_cast<EntityID*>(chunk->Memory)[lastIndex];
+			// 共有コンポーネントの参照を手放す (チャンクは削除で返却され得るため先に行う)
+			ReleaseSharedValues(loc.PtrArchetype, loc.PtrChunk);
 
-			if (loc.IndexInChunk != lastIndex)
+			// アーキタイプから削除 (Swap-back removal、空になったチャンクは同期ポイントで返却される)
+			EntityID movedEntityID = loc.PtrArchetype->RemoveEntity(loc.PtrChunk, loc.IndexInChunk);
+			if (movedEntityID != NullEntityID)
 			{
-				// データの移動
-				chunk->MoveEntityData(loc.PtrArchetype, lastIndex, loc.IndexInChunk);
-
 				// 移動させたEntityの住所録を更新
-				entityLocationMap[lastEntityID].IndexInChunk = loc.IndexInChunk;
+				entityManager.GetLocationByIndex(movedEntityID.Index).IndexInChunk = loc.IndexInChunk;
+				loc.PtrChunk->MarkAllChanged(GetWriteVersion());
 			}
 
-			// チャンクのカウントを減らす
-			chunk->Count--;
-
-			// マップから削除
-			entityLocationMap.erase(entity.ID);
-
-			// ID管理システムに返却
+			// ID管理システムに返却 (住所も同時に破棄される)
 			entityManager.DestroyEntity(entity);
 		}
 
@@ -152,13 +222,7 @@ namespace Span
 		 */
 		std::vector<Entity> GetAllEntities() const
 		{
-			std::vector<Entity> entities;
-			entities.reserve(entityLocationMap.size());
-			for (const auto& pair : entityLocationMap)
-			{
-				entities.push_back(Entity{ pair.first });
-			}
-			return entities;
+			return entityManager.GetAliveEntities();
 		}
 
 		/**
@@ -172,6 +236,297 @@ namespace Span
 			{
 				DestroyEntity(e);
 			}
+			ReleaseEmptyChunks();
+		}
+
+		/**
+		 * @brief	大量削除などで疎になったチャンクを詰め直し、空いたチャンクを返却します。
+		 *
+		 * @details
+		 * アーキタイプごとに、空いているチャンクの末尾から埋まっているチャンクへエンティティを移動し、
+		 * 住所録を更新します。`maxMoves` を指定すると移動数を制限でき、毎フレーム少しずつ実行できます
+		 * (続きは次回の呼び出しで、前回中断したアーキタイプから再開されます)。
+		 * エンティティのチャンク内位置が変わるため、構造的変更として扱われます。
+		 * 削除で空になったチャンクもここで返却されます (`UpdateSystems` の各Wave終了時にも返却されます)。
+		 *
+		 * @param	maxMoves 移動するエンティティ数の上限 (既定は無制限)
+		 * @return	移動したエンティティ数
+		 *
+		 * @code	{.cpp}
+		 * // ウェーブ終了後に一括で詰める
+		 * world.Compact();
+		 * // または毎フレーム最大256体ずつ
+		 * world.Compact(256);
+		 * @endcode
+		 */
+		uint32 Compact(uint32 maxMoves = UINT32_MAX)
+		{
+			ValidateStructuralChange("Compact");
+
+			ReleaseEmptyChunks();
+
+			const std::vector<Archetype*>& archetypes = archetypeManager.GetArchetypeList();
+			if (archetypes.empty()) return 0;
+
+			const uint32 version = GetWriteVersion();
+			auto onMoved = [this](EntityID id, Chunk* chunk, uint32 index)
+			{
+				EntityLocation& loc = entityManager.GetLocationByIndex(id.Index);
+				loc.PtrChunk = chunk;
+				loc.IndexInChunk = index;
+			};
+
+			// 前回中断したアーキタイプから一周する
+			uint32 moved = 0;
+			for (size_t n = 0; n < archetypes.size() && moved < maxMoves; ++n)
+			{
+				compactCursor %= archetypes.size();
+				Archetype* archetype = archetypes[compactCursor];
+
+				moved += archetype->Compact(maxMoves - moved, version, onMoved);
+				if (archetype->IsFragmented()) break;	// 予算切れ、次回はこのアーキタイプから
+
+				compactCursor++;
+			}
+			return moved;
+		}
+
+		/**
+		 * @brief	別のワールドのエンティティを、チャンクごとこのワールドへ移動します。
+		 *
+		 * @details
+		 * 条件に一致するアーキタイプの全チャンクを、コンポーネントデータをコピーせずにこのワールドへ付け替えます
+		 * (このワールドに既にある同じ構成のアーキタイプと型の並びが異なる場合のみ、列単位でコピーします)。
+		 * エンティティにはこのワールドで新しいIDが発行され、移動元のIDは破棄されます。
+		 * コンポーネント内に保持しているEntity (親子関係など) は書き換わらないため、`outRemap` を使って修正してください。
+		 *
+		 * 読み込みスレッドで別のワールドに構築したエンティティを、メインスレッドで一度に合流させる用途を想定しています。
+		 * 移動元・移動先の両方で構造的変更として扱われます。
+		 *
+		 * @tparam	ComponentTypes 移動するエンティティの条件 (`ForEach` と同じ項目、省略時は全エンティティ)。
+		 *			判定はアーキタイプ単位のため、`Changed<T>` などのフィルターや有効/無効の状態は考慮されません。
+		 * @param	source 移動元のワールド
+		 * @param	outRemap `(移動元のEntity, 新しいEntity)` の対応の追加先 (不要なら nullptr)
+		 * @return	移動したエンティティ数
+		 *
+		 * @code	{.cpp}
+		 * // 読み込みスレッドで構築
+		 * World staging;
+		 * LoadLevelSection(staging);
+		 *
+		 * // メインスレッドで合流
+		 * scene.ECSWorld.MoveEntitiesFrom(staging);
+		 * @endcode
+		 */
+		template <typename... ComponentTypes>
+		uint32 MoveEntitiesFrom(World& source, std::vector<std::pair<Entity, Entity>>* outRemap = nullptr)
+		{
+			if (&source == this) return 0;
+			ValidateStructuralChange("MoveEntitiesFrom");
+			source.ValidateStructuralChange("MoveEntitiesFrom");
+
+			// 1. 移動元の対象アーキタイプを列挙
+			std::vector<Archetype*> sourceArchetypes;
+			if constexpr (sizeof...(ComponentTypes) == 0)
+			{
+				sourceArchetypes = source.archetypeManager.GetArchetypeList();
+			}
+			else
+			{
+				for (const auto& match : source.GetCachedQueryState<ComponentTypes...>().Matches)
+				{
+					sourceArchetypes.push_back(match.PtrArchetype);
+				}
+			}
+
+			// 2. チャンクを1つずつ付け替える
+			const uint32 version = GetWriteVersion();
+			uint32 moved = 0;
+			for (Archetype* sourceArchetype : sourceArchetypes)
+			{
+				if (sourceArchetype->GetChunks().empty()) continue;
+
+				Archetype* archetype = GetOrCreateArchetypeLike(*sourceArchetype);
+				const bool sameLayout = archetype->HasSameLayout(*sourceArchetype);
+
+				while (!sourceArchetype->GetChunks().empty())
+				{
+					Chunk* chunk = sourceArchetype->GetChunks().back();
+					sourceArchetype->DetachChunk(chunk);
+					moved += chunk->Count;
+
+					// 共有値の番号を、このワールドのストアの番号に付け替える
+					TransferSharedValues(source, sourceArchetype, chunk);
+
+					if (sameLayout)
+					{
+						archetype->AdoptChunk(chunk);
+						ReassignEntities(source, chunk, 0, chunk->Count, outRemap);
+						chunk->MarkAllAdded(version);
+					}
+					else
+					{
+						CopyChunkInto(source, sourceArchetype, chunk, archetype, version, outRemap);
+						delete chunk;
+					}
+				}
+			}
+			return moved;
+		}
+
+		// 📸 Snapshot
+		// ============================================================
+
+		/**
+		 * @brief	ワールド全体の状態を保存します。
+		 *
+		 * @details
+		 * チャンクのメモリをブロック単位でコピーし、エンティティの世代番号・住所録・共有コンポーネント・リソースを丸ごと複製します。
+		 * JSONを経由しないため、エディタのPlay開始やゲームプレイのロールバックに使用できます。
+		 * システムとクエリのキャッシュは保存されません。
+		 *
+		 * @param	out 保存先 (以前の内容は破棄されます)
+		 */
+		void Snapshot(WorldSnapshot& out)
+		{
+			out.Clear();
+			out.owner = this;
+			entityManager.SaveSnapshot(out.entities);
+			out.sharedComponents.CopyFrom(sharedComponents);
+			out.resources.CopyFrom(resources, 0);
+
+			const std::vector<Archetype*>& archetypes = archetypeManager.GetArchetypeList();
+			out.archetypes.resize(archetypes.size());
+			for (size_t i = 0; i < archetypes.size(); ++i)
+			{
+				WorldSnapshot::ArchetypeData& data = out.archetypes[i];
+				data.PtrArchetype = archetypes[i];
+				data.Columns = GetSnapshotColumns(archetypes[i]);
+
+				const std::vector<Chunk*>& chunks = archetypes[i]->GetChunks();
+				data.Chunks.resize(chunks.size());
+				for (size_t j = 0; j < chunks.size(); ++j)
+				{
+					SaveChunk(*chunks[j], data.Chunks[j], data.Columns);
+				}
+			}
+		}
+
+		/**
+		 * @brief	`Snapshot` で保存した状態に戻します。
+		 *
+		 * @details
+		 * 保存以降に作成・変更・削除されたエンティティは全て保存時の状態に戻り、保存時のEntityハンドルが再び有効になります。
+		 * 復元されたチャンクは全列が変更扱いになります。
+		 * オブザーバーには、復元前の全エンティティの `OnRemove` と復元後の全エンティティの `OnAdd` が通知されます。
+		 * 構造的変更として扱われるため、システムの実行中には呼び出さないでください。
+		 *
+		 * @param	snapshot このワールドで保存したスナップショット
+		 * @return	復元できた場合は true
+		 */
+		bool Restore(const WorldSnapshot& snapshot)
+		{
+			if (snapshot.owner != this)
+			{
+				SPAN_ERROR("World::Restore: The snapshot was not taken from this world");
+				return false;
+			}
+			ValidateStructuralChange("Restore");
+
+			// 1. 現在のチャンクを破棄 (複製関数を持つ型はデストラクタを呼ぶ)
+			for (Archetype* archetype : archetypeManager.GetArchetypeList())
+			{
+				std::vector<WorldSnapshot::Column> columns = GetSnapshotColumns(archetype);
+				for (Chunk* chunk : archetype->GetChunks())
+				{
+					observers.Record(archetype, nullptr, std::span<const EntityID>(reinterpret_cast<const EntityID*>(chunk->Memory), chunk->Count));
+					for (const WorldSnapshot::Column& column : columns)
+					{
+						if (column.Ops.Destroy) column.Ops.Destroy(chunk->Memory + column.Offset, chunk->Count);
+					}
+				}
+				archetype->ReleaseAllChunks();
+			}
+
+			// 2. ID管理を復元
+			entityManager.LoadSnapshot(snapshot.entities);
+			sharedComponents.CopyFrom(snapshot.sharedComponents);
+
+			// 3. チャンクを復元し、住所録のチャンクを張り替える (リソースも全て変更扱いで戻す)
+			const uint32 version = GetWriteVersion();
+			resources.CopyFrom(snapshot.resources, version);
+			for (const WorldSnapshot::ArchetypeData& data : snapshot.archetypes)
+			{
+				for (const WorldSnapshot::ChunkData& saved : data.Chunks)
+				{
+					Chunk* chunk = data.PtrArchetype->CreateChunk(saved.SharedValues);
+					LoadChunk(saved, *chunk, data.Columns);
+					chunk->MarkAllChanged(version);
+
+					const EntityID* ids = reinterpret_cast<const EntityID*>(chunk->Memory);
+					for (uint32 i = 0; i < chunk->Count; ++i)
+					{
+						entityManager.GetLocationByIndex(ids[i].Index).PtrChunk = chunk;
+					}
+					observers.Record(nullptr, data.PtrArchetype, std::span<const EntityID>(ids, chunk->Count));
+				}
+			}
+
+			compactCursor = 0;
+			return true;
+		}
+
+		// 📊 Statistics
+		// ============================================================
+
+		/**
+		 * @brief	アーキタイプごとのメモリ使用量・チャンク充填率と、構造的変更の回数を集計します。
+		 * @details	全アーキタイプのチャンクを走査するため、毎フレームではなく計測・デバッグ表示の際に呼び出してください。
+		 *
+		 * @code	{.cpp}
+		 * WorldStats stats = world.GetStats();
+		 * SPAN_LOG("%s", stats.ToJson(10).c_str());	// メモリ使用量の上位10アーキタイプ
+		 * @endcode
+		 */
+		WorldStats GetStats() const
+		{
+			WorldStats stats;
+			stats.EntityCount = static_cast<uint32>(entityManager.GetActiveEntityCount());
+			stats.StructuralChangesLastFrame = structuralChangesLastFrame;
+			stats.StructuralChangesThisFrame = structuralChanges.load(std::memory_order_relaxed);
+
+			const std::vector<Archetype*>& archetypes = archetypeManager.GetArchetypeList();
+			stats.ArchetypeCount = static_cast<uint32>(archetypes.size());
+			stats.Archetypes.reserve(archetypes.size());
+
+			for (const Archetype* archetype : archetypes)
+			{
+				ArchetypeStats& entry = stats.Archetypes.emplace_back();
+				entry.Types = archetype->GetTypes();
+				entry.Types.insert(entry.Types.end(), archetype->GetSharedTypes().begin(), archetype->GetSharedTypes().end());
+
+				entry.ChunkCount = static_cast<uint32>(archetype->GetChunks().size());
+				entry.ChunkCapacity = archetype->GetChunkCapacity();
+				for (const Chunk* chunk : archetype->GetChunks()) entry.EntityCount += chunk->Count;
+
+				const size_t slots = static_cast<size_t>(entry.ChunkCount) * entry.ChunkCapacity;
+				entry.EntitySize = archetype->GetEntitySize();
+				entry.ChunkSize = archetype->GetChunkSize();
+				entry.AllocatedBytes = entry.ChunkCount * entry.ChunkSize;
+				entry.PaddingBytes = entry.ChunkCount * (entry.ChunkSize - entry.EntitySize * entry.ChunkCapacity);
+				entry.UnusedBytes = (slots - entry.EntityCount) * entry.EntitySize;
+				entry.FillRatio = slots ? static_cast<float>(entry.EntityCount) / static_cast<float>(slots) : 0.0f;
+				entry.BytesPerEntity = entry.EntityCount ? static_cast<double>(entry.AllocatedBytes) / entry.EntityCount : 0.0;
+
+				stats.ChunkCount += entry.ChunkCount;
+				stats.AllocatedBytes += entry.AllocatedBytes;
+				stats.PaddingBytes += entry.PaddingBytes;
+				stats.UnusedBytes += entry.UnusedBytes;
+			}
+
+			std::stable_sort(stats.Archetypes.begin(), stats.Archetypes.end(),
+				[](const ArchetypeStats& a, const ArchetypeStats& b) { return a.AllocatedBytes > b.AllocatedBytes; });
+			return stats;
 		}
 
 		// 🧩 Component Management
@@ -192,36 +547,49 @@ namespace Span
 		{
 			if (!IsAlive(entity)) return;
 			if (HasComponent<T>(entity)) return;
+			ValidateStructuralChange("AddComponent");
 
-			EntityLocation oldLoc = entityLocationMap[entity.ID];
-			Archetype* oldArchetype = oldLoc.PtrArchetype;
-
-			// 新しいアーキタイプ構成を作成
-			std::vector<ComponentTypeID> types = oldArchetype->GetTypes();
-			std::vector<size_t> sizes;
-			std::vector<size_t> aligns;
+			Archetype* oldArchetype = entityManager.GetLocationByIndex(entity.ID.Index).PtrArchetype;
+			ComponentTypeID addID = ComponentType<T>::GetID();
 
-			// 既存コンポーネント情報
-			for (auto id : types)
+			// 遷移グラフに辺があれば1回の参照で遷移先が決まる
+			Archetype* newArchetype = oldArchetype->GetAddEdge(addID);
+			if (!newArchetype)
 			{
-				sizes.push_back(oldArchetype->GetComponentSize(id));
-				aligns.push_back(oldArchetype->GetComponentAlignment(id));
-			}
+				// 新しいアーキタイプ構成を作成
+				std::vector<ComponentTypeID> types = oldArchetype->GetTypes();
+				std::vector<size_t> sizes;
+				std::vector<size_t> aligns;
+
+				// 既存コンポーネント情報
+				for (auto id : types)
+				{
+					sizes.push_back(oldArchetype->GetComponentSize(id));
+					aligns.push_back(oldArchetype->GetComponentAlignment(id));
+				}
+
+				// 新規コンポーネント追加
+				types.push_back(addID);
+				sizes.push_back(ComponentType<T>::GetSize());
+				aligns.push_back(alignof(T));
 
-			// 新規コンポーネント追加
-			types.push_back(ComponentType<T>::GetID());
-			sizes.push_back(sizeof(T));
-			aligns.push_back(alignof(T));
+				newArchetype = archetypeManager.GetOrCreateArchetype(types, sizes, aligns, oldArchetype->GetSharedTypes());
 
-			Archetype* newArchetype = archetypeManager.GetOrCreateArchetype(types, sizes, aligns);
+				// 双方向の辺をキャッシュ
+				oldArchetype->SetAddEdge(addID, newArchetype);
+				newArchetype->SetRemoveEdge(addID, oldArchetype);
+			}
 
 			// データ移行
 			MigrateEntity(entity, newArchetype);
 
-			// 新しいコンポーネントに値を設定
-			if (T* ptr = GetComponentPtr<T>(entity))
+			// 新しいコンポーネントに値を設定 (タグは実体を持たない)
+			if constexpr (!ComponentType<T>::IsTag)
 			{
-				new (ptr) T(initialValue);
+				if (T* ptr = GetComponentPtr<T>(entity))
+				{
+					new (ptr) T(initialValue);
+				}
 			}
 		}
 
@@ -238,32 +606,40 @@ namespace Span
 		{
 			if (!IsAlive(entity)) return;
 			if (!HasComponent<T>(entity)) return;
+			ValidateStructuralChange("RemoveComponent");
 
 			if (T* ptr = GetComponentPtr<T>(entity))
 			{
 				ptr->~T();
 			}
 
-			EntityLocation oldLoc = entityLocationMap[entity.ID];
-			Archetype* oldArchetype = oldLoc.PtrArchetype;
-
-			// 新しいアーキタイプ構成を作成
-			std::vector<ComponentTypeID> types;
-			std::vector<size_t> sizes;
-			std::vector<size_t> aligns;
-
+			Archetype* oldArchetype = entityManager.GetLocationByIndex(entity.ID.Index).PtrArchetype;
 			ComponentTypeID removeID = ComponentType<T>::GetID();
 
-			for (auto id : oldArchetype->GetTypes())
+			// 遷移グラフに辺があれば1回の参照で遷移先が決まる
+			Archetype* newArchetype = oldArchetype->GetRemoveEdge(removeID);
+			if (!newArchetype)
 			{
-				if (id == removeID) continue;
+				// 新しいアーキタイプ構成を作成
+				std::vector<ComponentTypeID> types;
+				std::vector<size_t> sizes;
+				std::vector<size_t> aligns;
 
-				types.push_back(id);
-				sizes.push_back(oldArchetype->GetComponentSize(id));
-				aligns.push_back(oldArchetype->GetComponentAlignment(id));
-			}
+				for (auto id : oldArchetype->GetTypes())
+				{
+					if (id == removeID) continue;
+
+					types.push_back(id);
+					sizes.push_back(oldArchetype->GetComponentSize(id));
+					aligns.push_back(oldArchetype->GetComponentAlignment(id));
+				}
 
-			Archetype* newArchetype = archetypeManager.GetOrCreateArchetype(types, sizes, aligns);
+				newArchetype = archetypeManager.GetOrCreateArchetype(types, sizes, aligns, oldArchetype->GetSharedTypes());
+
+				// 双方向の辺をキャッシュ
+				oldArchetype->SetRemoveEdge(removeID, newArchetype);
+				newArchetype->SetAddEdge(removeID, oldArchetype);
+			}
 
 			// データ移行
 			MigrateEntity(entity, newArchetype);
@@ -275,52 +651,60 @@ namespace Span
 		template <typename T>
 		bool HasComponent(Entity entity)
 		{
-			if (!IsAlive(entity)) return false;
-			auto it = entityLocationMap.find(entity.ID);
-			if (it == entityLocationMap.end()) return false;
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return false;
 
 			// アーキタイプがそのコンポーネントを持っているか確認
-			return it->second.PtrArchetype->HasComponent(ComponentType<T>::GetID());
+			return loc->PtrArchetype->HasComponent(ComponentType<T>::GetID());
 		}
 
 		/**
 		 * @brief	コンポーネントへの参照を取得します。
 		 *
-		 * @tparam	T 取得したいコンポーネントの型
+		 * @tparam	T 取得したいコンポーネントの型 (`const T` で読み取り専用アクセス)
 		 * @param	entity 対象エンティティ
-		 * @return	コンポーネントへの参照。持っていない場合は `nullptr`。
+		 * @return	コンポーネントへの参照。持っていない場合はダミーへの参照。
+		 * @note	非constで取得すると、チャンクの変更バージョンが更新されます (`Changed<T>` の対象になります)。
 		 */
 		template <typename T>
 		T& GetComponent(Entity entity)
 		{
-			if (!HasComponent<T>(entity))
+			if (T* ptr = GetComponentPtr<T>(entity))
 			{
-				static T dummy{};
-				return dummy;
+				return *ptr;
 			}
 
-			return GetComponentUnsafe<T>(entityLocationMap[entity.ID]);
+			static T dummy{};
+			return dummy;
 		}
 
 		/**
 		 * @brief	コンポーネントへのポインタを取得します。
 		 *
-		 * @tparam	T 取得したいコンポーネントの型
+		 * @tparam	T 取得したいコンポーネントの型 (`const T` で読み取り専用アクセス)
 		 * @param	entity 対象エンティティ
 		 * @return	コンポーネントへのポインタ。持っていない場合は `nullptr`。
+		 * @note	非constで取得すると、チャンクの変更バージョンが更新されます (`Changed<T>` の対象になります)。
 		 */
 		template <typename T>
 		T* GetComponentPtr(Entity entity)
 		{
-			if (!IsAlive(entity)) return nullptr;
+			ValidateAccess<T>();
 
-			auto it = entityLocationMap.find(entity.ID);
-			if (it == entityLocationMap.end()) return nullptr;
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return nullptr;
 
 			// 持っていない場合
-			if (!it->second.PtrArchetype->HasComponent(ComponentType<T>::GetID())) return nullptr;
+			ComponentTypeID typeID = ComponentType<T>::GetID();
+			if (!loc->PtrArchetype->HasComponent(typeID)) return nullptr;
 
-			return &GetComponentUnsafe<T>(it->second);
+			// 書き込み目的の取得は変更として記録
+			if constexpr (!std::is_const_v<T>)
+			{
+				loc->PtrChunk->MarkChanged(loc->PtrArchetype->GetColumnIndex(typeID), GetWriteVersion());
+			}
+
+			return &GetComponentUnsafe<T>(*loc);
 		}
 
 		/**
@@ -336,137 +720,845 @@ namespace Span
 			}
 		}
 
-		// ⚙ System Management
-		// ============================================================
-
 		/**
-		 * @brief	システムをワールドに登録します。
+		 * @brief	コンポーネントの有効/無効を切り替えます。
 		 *
-		 * @tparam	T Systemクラス (Systemを継承していること)
-		 * @param	args システムのコンストラクタに渡す引数
-		 * @return	登録されたシステムへの生ポインタ
+		 * @details
+		 * 無効化されたコンポーネントを持つエンティティは、そのコンポーネントを含むクエリの対象外になります。
+		 * `RemoveComponent` と異なりアーキタイプ間の移動が発生せず、データもそのまま保持されます。
+		 * ビット操作はアトミックなため、`ForEachParallel` の中から呼び出すこともできます。
+		 *
+		 * @tparam	T 対象のコンポーネント型
+		 * @param	entity 対象エンティティ
+		 * @param	enabled 有効にする場合は true
+		 * @note	エンティティがそのコンポーネントを持っていない場合、処理はスキップされます。
 		 */
-		template <typename T, typename... Args>
-		T* AddSystem(Args&&... args)
+		template <typename T>
+		void SetComponentEnabled(Entity entity, bool enabled)
 		{
-			// メモリ確保して所有権を持つ
-			auto sys = std::make_unique<T>(std::forward<Args>(args)...);
-			T* rawPtr = sys.get();
+			ValidateAccess<T>();
 
-			// 初期化
-			rawPtr->Initialize(this);
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return;
 
-			systems.push_back(std::move(sys));
-			return rawPtr;
-		}
+			ComponentTypeID typeID = ComponentType<T>::GetID();
+			if (!loc->PtrArchetype->HasComponent(typeID)) return;
 
-		/**
-		 * @brief	全システムのアクティブな `OnUpdate` を呼び出します。
-		 * @details	通常、ゲームループの毎フレームで呼び出されます。
-		 */
-		void UpdateSystems()
-		{
-			for (auto& sys : systems)
+			uint32 column = loc->PtrArchetype->GetColumnIndex(typeID);
+			if (loc->PtrChunk->SetEnabled(column, loc->IndexInChunk, enabled))
 			{
-				if (sys->IsEnabled())
-				{
-					sys->OnUpdate();
-				}
+				loc->PtrChunk->MarkChanged(column, GetWriteVersion());
 			}
 		}
 
 		/**
-		 * @brief	全システムの終了処理を行い、リストをクリアします。
+		 * @brief	コンポーネントが有効か確認します。
+		 * @return	コンポーネントを持っていて、かつ有効な場合は true
 		 */
-		void ShutdownSystem()
+		template <typename T>
+		bool IsComponentEnabled(Entity entity)
 		{
-			for (auto& sys : systems)
-			{
-				sys->OnDestroy();
-			}
-			systems.clear();
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return false;
+
+			ComponentTypeID typeID = ComponentType<T>::GetID();
+			if (!loc->PtrArchetype->HasComponent(typeID)) return false;
+
+			return loc->PtrChunk->IsEnabled(loc->PtrArchetype->GetColumnIndex(typeID), loc->IndexInChunk);
 		}
 
-		// 🔄 Query / Iteration
+		// 🤝 Shared Components
 		// ============================================================
 
 		/**
-		 * @brief	指定したコンポーネントを持つ全てのEntityに対して関数を実行します。
+		 * @brief	共有コンポーネントの値を設定します (持っていなければ追加します)。
+		 *
 		 * @details
-		 * アーキタイプごとに整理されたメモリ (Chunk) をシーケンシャルにアクセスするため、
-		 * 非常にキャッシュ効率が良く、高速に動作します。
+		 * 共有コンポーネントの値はチャンクごとに1つだけ保持され、値が異なるエンティティは別のチャンクに格納されます。
+		 * 値を変更するとエンティティは別のチャンクへ移動するため、構造的変更として扱われます。
+		 * クエリでは `Shared<T>` として読み取り専用で受け取れます。
 		 *
-		 * @tparam	ComponentTypes 要求するコンポーネントの型リスト
-		 * @param	func 実行するラムダ式 `[](Entity e, ComponentType&... comps) { ... }`
+		 * @tparam	T 共有コンポーネントの型 (`operator==` で比較でき、`std::hash<T>` の特殊化があるか、パディングを含まないこと)
+		 * @param	entity 対象エンティティ
+		 * @param	value 設定する値 (同じ値はワールド内で1つにまとめられます)
 		 *
 		 * @code	{.cpp}
-		 * // 全てのTransformを持つエンティティの位置を更新
-		 * world.ForEach<Transform, Velocity>([](Entity e, Transform& t, Velocity& v)
-		 * {
-		 *     t.Position += v.Value * DeltaTime;
-		 * });
+		 * world.SetSharedComponent(e, RenderMaterial{ material });
+		 * world.ForEach<Shared<RenderMaterial>, const LocalToWorld>([&](Entity, const RenderMaterial& mat, const LocalToWorld& ltw) { ... });
 		 * @endcode
 		 */
-		template <typename... ComponentTypes, typename Func>
-		void ForEach(Func&& func)
+		template <typename T>
+		void SetSharedComponent(Entity entity, const T& value)
 		{
-			// 1. 検索対象の型IDリストを作成
-			std::vector<ComponentTypeID> queryTypes = { ComponentType<ComponentTypes>::GetID()... };
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return;
+			ValidateStructuralChange("SetSharedComponent");
 
-			// 2. 全アーキタイプを走査
-			const auto& allArchetypes = archetypeManager.GetAllArchetypes();
+			ComponentTypeID sharedID = ComponentType<Shared<T>>::GetID();
+			uint32 valueIndex = sharedComponents.Acquire(value);
 
-			for (const auto& pair : allArchetypes)
+			Archetype* oldArchetype = loc->PtrArchetype;
+			if (oldArchetype->HasComponent(sharedID))
 			{
-				Archetype* arch = pair.second;
-
-				// 3. 条件に合うアーキタイプか
-				if (!arch->HasAllComponents(queryTypes))
-				{
-					continue;
-				}
-
-				// 4. チャンクごとの処理
-				auto offsets = std::make_tuple(arch->GetComponentOffset(ComponentType<ComponentTypes>::GetID())...);
+				// 同じアーキタイプ内の、新しい値のチャンクへ移動する
+				std::vector<uint32> sharedValues = loc->PtrChunk->SharedValues;
+				uint32& current = sharedValues[oldArchetype->GetSharedIndex(sharedID)];
 
-				for (Chunk* chunk : arch->GetChunks())
+				uint32 previous = current;
+				if (previous != valueIndex)
 				{
-					if (chunk->Count == 0) continue;
-
-					// 5. 各コンポーネント配列の先頭ポインタを取得して実行
-					ProcessChunk<ComponentTypes...>(chunk, chunk->Count, offsets, func);
+					current = valueIndex;
+					MigrateEntity(entity, oldArchetype, sharedValues);
 				}
+				sharedComponents.Release(sharedID, previous);
+				return;
 			}
+
+			// 共有コンポーネントを加えたアーキタイプへ移動する
+			Archetype* newArchetype = GetSharedTransition(oldArchetype, sharedID, true);
+			std::vector<uint32> sharedValues = CarrySharedValues(oldArchetype, loc->PtrChunk, newArchetype);
+			sharedValues[newArchetype->GetSharedIndex(sharedID)] = valueIndex;
+			MigrateEntity(entity, newArchetype, sharedValues);
 		}
 
-	private:
-		EntityManager entityManager;
-		ArchetypeManager archetypeManager;
+		/**
+		 * @brief	共有コンポーネントを削除します。
+		 * @tparam	T 削除する共有コンポーネントの型
+		 */
+		template <typename T>
+		void RemoveSharedComponent(Entity entity)
+		{
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return;
 
-		// システムの所有権リスト
-		std::vector<std::unique_ptr<System>> systems;
+			ComponentTypeID sharedID = ComponentType<Shared<T>>::GetID();
+			Archetype* oldArchetype = loc->PtrArchetype;
+			if (!oldArchetype->HasComponent(sharedID)) return;
+			ValidateStructuralChange("RemoveSharedComponent");
 
-		// ID -> 住所 の高速検索マップ
-		std::unordered_map<EntityID, EntityLocation> entityLocationMap;	///< IDからメモリ位置への高速ルックアップテーブル
+			uint32 previous = loc->PtrChunk->SharedValues[oldArchetype->GetSharedIndex(sharedID)];
 
-		// --- Internal Helper Methods ---
+			Archetype* newArchetype = GetSharedTransition(oldArchetype, sharedID, false);
+			MigrateEntity(entity, newArchetype, CarrySharedValues(oldArchetype, loc->PtrChunk, newArchetype));
 
-		// アーキタイプ間の移動
-		void MigrateEntity(Entity entity, Archetype* newArchetype)
+			sharedComponents.Release(sharedID, previous);
+		}
+
+		/**
+		 * @brief	指定した共有コンポーネントを持っているか確認します。
+		 */
+		template <typename T>
+		bool HasSharedComponent(Entity entity)
+		{
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			if (!loc) return false;
+
+			return loc->PtrArchetype->HasComponent(ComponentType<Shared<T>>::GetID());
+		}
+
+		/**
+		 * @brief	共有コンポーネントの値を取得します。
+		 * @return	値への参照。持っていない場合はダミーへの参照。
+		 * @note	値を変更する場合は `SetSharedComponent` を使用してください。
+		 */
+		template <typename T>
+		const T& GetSharedComponent(Entity entity)
+		{
+			ValidateAccess<const Shared<T>>();
+
+			const EntityLocation* loc = entityManager.GetLocation(entity);
+			ComponentTypeID sharedID = ComponentType<Shared<T>>::GetID();
+			if (!loc || !loc->PtrArchetype->HasComponent(sharedID))
+			{
+				static const T dummy{};
+				return dummy;
+			}
+
+			return sharedComponents.Get<T>(loc->PtrChunk->SharedValues[loc->PtrArchetype->GetSharedIndex(sharedID)]);
+		}
+
+		/// @brief	ワールド内で使用されている共有コンポーネント `T` の値の種類数を取得します。
+		template <typename T>
+		uint32 GetSharedComponentValueCount() const
+		{
+			return sharedComponents.GetValueCount<T>();
+		}
+
+		// 🌐 Resources
+		// ============================================================
+
+		/**
+		 * @brief	リソース (ワールドに1つだけ存在するデータ) を設定します (既にあれば上書きします)。
+		 *
+		 * @details
+		 * アクティブなカメラ・レンダリング設定など、フレーム全体で共有するデータをクエリの走査無しで参照するために使用します。
+		 * エンティティを持たないため、構造的変更にはなりません。
+		 * 新しい型のリソースはメインスレッド (システムの `OnCreate` や非宣言のシステム) から設定してください。
+		 *
+		 * @tparam	T リソースの型
+		 * @param	value 設定する値
+		 * @return	格納された値への参照
+		 *
+		 * @code	{.cpp}
+		 * world.SetResource(ActiveCamera{ ... });
+		 * if (const ActiveCamera* camera = world.GetResource<const ActiveCamera>()) { ... }
+		 * @endcode
+		 */
+		template <typename T>
+		T& SetResource(T value)
+		{
+			ValidateAccess<Resource<T>>();
+			return resources.Set(std::move(value), GetWriteVersion());
+		}
+
+		/**
+		 * @brief	リソースへのポインタを取得します。
+		 *
+		 * @tparam	T リソースの型 (`const T` で読み取り専用アクセス)
+		 * @return	設定されていない場合は `nullptr`
+		 * @note	非constで取得すると、リソースの変更バージョンが更新されます (`IsResourceChanged<T>` の対象になります)。
+		 */
+		template <typename T>
+		T* GetResource()
+		{
+			using ValueType = std::remove_const_t<T>;
+			ValidateAccess<std::conditional_t<std::is_const_v<T>, const Resource<ValueType>, Resource<ValueType>>>();
+
+			// 書き込み目的の取得は変更として記録
+			if constexpr (!std::is_const_v<T>)
+			{
+				resources.MarkChanged<ValueType>(GetWriteVersion());
+			}
+
+			return resources.Find<ValueType>();
+		}
+
+		/// @brief	リソースが設定されているか確認します。
+		template <typename T>
+		bool HasResource() const
+		{
+			return resources.Find<std::remove_const_t<T>>() != nullptr;
+		}
+
+		/**
+		 * @brief	リソースを削除します。
+		 * @note	取得済みのポインタは無効になります。
+		 */
+		template <typename T>
+		void RemoveResource()
+		{
+			ValidateAccess<Resource<T>>();
+			resources.Remove<T>();
+		}
+
+		/**
+		 * @brief	リソースが、実行中のシステムの前回実行以降に書き込まれたか確認します。
+		 * @details	`Changed<T>` と同じ基準です。システム外から呼び出した場合は、リソースがあれば常に true になります。
+		 */
+		template <typename T>
+		bool IsResourceChanged() const
+		{
+			const uint32 version = resources.GetChangedVersion<std::remove_const_t<T>>();
+			return version != 0 && Chunk::IsNewerVersion(version, GetFilterVersion());
+		}
+
+		// ⚙ System Management
+		// ============================================================
+
+		/**
+		 * @brief	システムをワールドに登録します。
+		 *
+		 * @tparam	T Systemクラス (Systemを継承していること)
+		 * @param	args システムのコンストラクタに渡す引数
+		 * @return	登録されたシステムへの生ポインタ
+		 */
+		template <typename T, typename... Args>
+		T* AddSystem(Args&&... args)
+		{
+			// メモリ確保して所有権を持つ
+			auto sys = std::make_unique<T>(std::forward<Args>(args)...);
+			T* rawPtr = sys.get();
+
+			// 初期化 (OnCreate内でアクセス宣言が行われる)
+			rawPtr->Initialize(this);
+
+			systems.push_back(std::move(sys));
+			isScheduleDirty = true;
+			return rawPtr;
+		}
+
+		/**
+		 * @brief	全システムのアクティブな `OnUpdate` を呼び出します。
+		 * @details
+		 * 通常、ゲームループの毎フレームで呼び出されます。
+		 * システムは宣言されたアクセス (`SystemAccess`) から構築したスケジュールに従い、
+		 * 競合しないもの同士がワーカースレッド上で同時に実行されます。
+		 * 競合するシステム間では登録順が保たれます。
+		 */
+		void UpdateSystems()
+		{
+			// 構造的変更の回数はこの呼び出しを区切りに数える
+			structuralChangesLastFrame = structuralChanges.exchange(0, std::memory_order_relaxed);
+
+			if (isScheduleDirty)
+			{
+				BuildSchedule();
+			}
+
+			// 並列実行中にバッファの配列が伸びないよう、先に全スレッド分を用意する
+			PrepareCommandBuffers();
+
+			std::vector<System*> runnable;
+			for (const auto& wave : scheduleWaves)
+			{
+				runnable.clear();
+				for (System* sys : wave)
+				{
+					if (sys->IsEnabled()) runnable.push_back(sys);
+				}
+
+				if (runnable.empty()) continue;
+
+				// 単独ならメインスレッドでそのまま実行 (排他システムは常にこちら)
+				if (runnable.size() == 1)
+				{
+					RunSystem(runnable[0]);
+				}
+				else
+				{
+					// 同じWave内のシステムは互いに競合しないため並列に実行する
+					// (共有のクエリキャッシュが並列実行中に書き換わらないよう、先に最新にしておく)
+					UpdateCachedQueryStates();
+
+					JobCounter counter;
+					for (size_t i = 1; i < runnable.size(); ++i)
+					{
+						System* sys = runnable[i];
+						JobSystem::Execute(counter, [this, sys]() { RunSystem(sys); });
+					}
+					RunSystem(runnable[0]);
+					JobSystem::Wait(counter);
+				}
+
+				// Waveの終了が同期ポイント: 記録された構造的変更をまとめて反映し、オブザーバーへ通知する
+				PlaybackCommandBuffers();
+				FlushObservers();
+				ReleaseEmptyChunks();
+			}
+		}
+
+		/**
+		 * @brief	全システムの終了処理を行い、リストをクリアします。
+		 */
+		void ShutdownSystem()
+		{
+			for (auto& sys : systems)
+			{
+				sys->OnDestroy();
+			}
+			systems.clear();
+			scheduleWaves.clear();
+			isScheduleDirty = true;
+		}
+
+		// 👀 Observers
+		// ============================================================
+
+		/**
+		 * @brief	コンポーネント `T` の追加・削除を監視するオブザーバーを登録します。
+		 *
+		 * @details
+		 * 構造的変更の時点ではコールバックは呼ばれず、対象のエンティティが記録されるだけです。
+		 * 通知は同期ポイント (`UpdateSystems` の各Wave終了時、または `FlushObservers` の呼び出し時) に、
+		 * 前回の通知以降の全エンティティをまとめて行います。
+		 *
+		 * - `OnAdd`: 通知時点で生存していて `T` を持つエンティティのみが、チャンクごとにまとめて渡されます。
+		 *   同じチャンクのエンティティが並んでいるため、コンポーネントの値もチャンク単位で読み取れます。
+		 * - `OnRemove`: コンポーネントの値は既に無く、エンティティも破棄済みの場合があります。
+		 *   通知までの間に追加と削除が両方行われたエンティティも含まれるため、「あれば取り除く」として扱ってください。
+		 *
+		 * 同じ通知の中で、1つのエンティティは1回だけ渡されます。`OnRemove` は `OnAdd` より先に通知されます。
+		 *
+		 * @tparam	T 監視するコンポーネントの型 (タグ・`Shared<T>` も指定できます)
+		 * @param	event 監視するイベント
+		 * @param	callback `[](World& world, std::span<const Entity> entities) { ... }` (メインスレッドで呼ばれます)
+		 * @return	登録番号 (`RemoveObserver` で使用)
+		 *
+		 * @code	{.cpp}
+		 * world.Observe<Collider>(ObserverEvent::OnAdd, [&](World& w, std::span<const Entity> entities)
+		 * {
+		 *     for (Entity e : entities) spatialIndex.Insert(e, w.GetComponent<const Collider>(e).Bounds);
+		 * });
+		 * world.Observe<Collider>(ObserverEvent::OnRemove, [&](World&, std::span<const Entity> entities)
+		 * {
+		 *     for (Entity e : entities) spatialIndex.Erase(e);
+		 * });
+		 * @endcode
+		 */
+		template <typename T>
+		ObserverID Observe(ObserverEvent event, ObserverCallback callback)
+		{
+			return observers.Add(ComponentType<T>::GetID(), event, std::move(callback));
+		}
+
+		/**
+		 * @brief	オブザーバーの登録を解除します。
+		 * @param	id `Observe` の戻り値
+		 * @note	解除したオブザーバーの通知待ちのエンティティは破棄されます。
+		 */
+		void RemoveObserver(ObserverID id)
+		{
+			observers.Remove(id);
+		}
+
+		/**
+		 * @brief	記録されたコンポーネントの追加・削除を、オブザーバーへまとめて通知します。
+		 * @details
+		 * システムの外 (エディタ等) で行った構造的変更をすぐに反映したい場合に呼び出します。
+		 * コールバック内で行われた構造的変更は、次回の通知で渡されます。
+		 * @note	並列処理中には呼び出さないでください (メインスレッドの同期ポイント専用)。
+		 */
+		void FlushObservers()
+		{
+			if (observers.GetObservedTypes().empty()) return;
+
+			// コールバック内で監視が解除されても良いように、型の一覧は複製して辿る
+			const std::vector<ComponentTypeID> observedTypes = observers.GetObservedTypes();
+			std::vector<Entity> entities;
+
+			for (ComponentTypeID typeID : observedTypes)
+			{
+				// 1. 削除: 重複を除いてまとめて通知
+				observers.TakePending(typeID, ObserverEvent::OnRemove, entities);
+				if (!entities.empty())
+				{
+					std::sort(entities.begin(), entities.end());
+					entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+					observers.Notify(typeID, ObserverEvent::OnRemove, *this, entities);
+				}
+
+				// 2. 追加: 現在も持っているものだけを、チャンク内の並び順でチャンクごとに通知
+				observers.TakePending(typeID, ObserverEvent::OnAdd, entities);
+				std::erase_if(entities, [&](Entity entity)
+				{
+					const EntityLocation* loc = entityManager.GetLocation(entity);
+					return !loc || !loc->PtrArchetype->HasComponent(typeID);
+				});
+				if (entities.empty()) continue;
+
+				auto location = [this](Entity entity) { return &entityManager.GetLocationByIndex(entity.ID.Index); };
+				std::sort(entities.begin(), entities.end(), [&](Entity a, Entity b)
+				{
+					const EntityLocation* locA = location(a);
+					const EntityLocation* locB = location(b);
+					if (locA->PtrChunk != locB->PtrChunk) return std::less<const Chunk*>()(locA->PtrChunk, locB->PtrChunk);
+					return locA->IndexInChunk < locB->IndexInChunk;
+				});
+				entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+				// コールバック内の構造的変更で住所が変わる前に、チャンクの境界を求めておく
+				std::vector<size_t> boundaries = { 0 };
+				for (size_t i = 1; i < entities.size(); ++i)
+				{
+					if (location(entities[i])->PtrChunk != location(entities[i - 1])->PtrChunk) boundaries.push_back(i);
+				}
+				boundaries.push_back(entities.size());
+
+				for (size_t i = 0; i + 1 < boundaries.size(); ++i)
+				{
+					observers.Notify(typeID, ObserverEvent::OnAdd, *this,
+						std::span<const Entity>(entities.data() + boundaries[i], boundaries[i + 1] - boundaries[i]));
+				}
+			}
+		}
+
+		// 📝 Deferred Commands
+		// ============================================================
+
+		/**
+		 * @brief	現在のスレッド専用のコマンドバッファを取得します。
+		 *
+		 * @details
+		 * スレッドごとに別のバッファを返すため、並列ジョブ内からもロック無しで記録できます。
+		 * 記録されたコマンドは、`UpdateSystems` の各Wave終了時、
+		 * または `PlaybackCommandBuffers` の呼び出し時にまとめて実行されます。
+		 * @note	メインスレッドとワーカースレッド専用です。`JobSystem` が管理していないスレッドからは呼び出せません。
+		 */
+		EntityCommandBuffer& GetCommandBuffer()
+		{
+			uint32 index = JobSystem::GetThreadIndex();
+			if (index == JobSystem::INVALID_THREAD_INDEX)
+			{
+				// 管理外のスレッドがメインのバッファへ同時に記録すると競合するため、許可しない
+				// (JobSystem 未起動時は全ての処理が呼び出し元で実行されるため、メインとして扱う)
+				if (JobSystem::IsInitialized())
+				{
+					SPAN_FATAL("World: GetCommandBuffer called from a thread not managed by JobSystem");
+				}
+				index = 0;
+			}
+
+			if (index >= commandBuffers.size())
+			{
+				// 並列実行の外 (メインスレッド) から初めて呼ばれた場合のみ
+				PrepareCommandBuffers();
+			}
+			return *commandBuffers[index];
+		}
+
+		/**
+		 * @brief	全スレッドのコマンドバッファを、スレッド番号順に実行します。
+		 * @note	並列処理中には呼び出さないでください (メインスレッドの同期ポイント専用)。
+		 */
+		void PlaybackCommandBuffers()
+		{
+			for (auto& buffer : commandBuffers)
+			{
+				buffer->Playback(*this);
+			}
+		}
+
+		// 🔄 Query / Iteration
+		// ============================================================
+
+		/**
+		 * @brief	指定したコンポーネントを持つ全てのEntityに対して関数を実行します。
+		 * @details
+		 * アーキタイプごとに整理されたメモリ (Chunk) をシーケンシャルにアクセスするため、
+		 * 非常にキャッシュ効率が良く、高速に動作します。
+		 *
+		 * 非constで要求したコンポーネントは、処理したチャンクの変更バージョンが更新されます。
+		 *
+		 * @tparam	ComponentTypes 要求するコンポーネントの型リスト (`const T` で読み取り専用、`Changed<T>` / `Added<T>` でフィルター)
+		 * @param	func 実行するラムダ式 `[](Entity e, ComponentType&... comps) { ... }`
+		 *
+		 * @code	{.cpp}
+		 * // 全てのTransformを持つエンティティの位置を更新
+		 * world.ForEach<Transform, Velocity>([](Entity e, Transform& t, Velocity& v)
+		 * {
+		 *     t.Position += v.Value * DeltaTime;
+		 * });
+		 *
+		 * // 前回の実行以降にTransformが書き込まれたチャンクのみ処理
+		 * world.ForEach<Changed<const Transform>, LocalToWorld>([](Entity e, const Transform& t, LocalToWorld& ltw) { ... });
+		 * @endcode
+		 */
+		template <typename... ComponentTypes, typename Func>
+		void ForEach(Func&& func)
+		{
+			ValidateQueryAccess<ComponentTypes...>();
+
+			// 一致するアーキタイプはキャッシュから取得 (新規アーキタイプの差分のみ検査)
+			IterateQuery<ComponentTypes...>(GetCachedQueryState<ComponentTypes...>(), MakeEntityProcessor<ComponentTypes...>(func));
+		}
+
+		/**
+		 * @brief	`ForEach` の並列版。条件に合うチャンクをバッチに分け、ワーカースレッドで実行します。
+		 * @details
+		 * チャンク単位で分割するため、1つのチャンクが複数スレッドに跨ることはありません。
+		 * ラムダ内では自分以外のエンティティへの書き込みや、構造的変更 (Add/Remove/Destroy) を行わないでください。
+		 * `JobSystem` が未初期化の場合は `ForEach` と同様に呼び出し元スレッドで実行されます。
+		 *
+		 * @tparam	ComponentTypes 要求するコンポーネントの型リスト
+		 * @param	func 実行するラムダ式 (複数スレッドから同時に呼ばれます)
+		 * @param	minBatchSize 1ジョブあたりの最小エンティティ数
+		 *
+		 * @code	{.cpp}
+		 * world.ForEachParallel<Transform, Velocity>([](Entity e, Transform& t, Velocity& v)
+		 * {
+		 *     t.Position += v.Value * DeltaTime;
+		 * }, 256);
+		 * @endcode
+		 */
+		template <typename... ComponentTypes, typename Func>
+		void ForEachParallel(Func&& func, uint32 minBatchSize = DEFAULT_PARALLEL_BATCH_SIZE)
+		{
+			ValidateQueryAccess<ComponentTypes...>();
+
+			IterateQueryParallel<ComponentTypes...>(GetCachedQueryState<ComponentTypes...>(), MakeEntityProcessor<ComponentTypes...>(func), minBatchSize);
+		}
+
+		/**
+		 * @brief	条件に合うチャンクごとに関数を実行します。
+		 *
+		 * @details
+		 * エンティティ単位ではなく、チャンク内のコンポーネント配列 (`std::span`) をまとめて受け取ります。
+		 * 配列の先頭は64バイト境界に揃っているため、自動ベクトル化やSIMD命令での処理に適しています。
+		 * `Changed<T>` などのフィルターや書き込みの変更記録は `ForEach` と同じく適用されます。
+		 *
+		 * @tparam	ComponentTypes 要求するコンポーネントの型リスト
+		 * @param	func `[](ChunkView view) { ... }`
+		 *
+		 * @code	{.cpp}
+		 * world.ForEachChunk<Transform, const Velocity>([&](ChunkView view)
+		 * {
+		 *     std::span<Transform> t = view.GetColumn<Transform>();
+		 *     std::span<const Velocity> v = view.GetColumn<const Velocity>();
+		 *     for (uint32 i = 0; i < view.GetCount(); ++i) t[i].Position += v[i].Value * dt;
+		 * });
+		 * @endcode
+		 */
+		template <typename... ComponentTypes, typename Func>
+		void ForEachChunk(Func&& func)
+		{
+			ValidateQueryAccess<ComponentTypes...>();
+
+			IterateQuery<ComponentTypes...>(GetCachedQueryState<ComponentTypes...>(), MakeChunkProcessor<ComponentTypes...>(func));
+		}
+
+		/**
+		 * @brief	`ForEachChunk` の並列版。チャンクをバッチに分け、ワーカースレッドで実行します。
+		 * @param	func `[](ChunkView view) { ... }` (複数スレッドから同時に呼ばれます)
+		 * @param	minBatchSize 1ジョブあたりの最小エンティティ数
+		 */
+		template <typename... ComponentTypes, typename Func>
+		void ForEachChunkParallel(Func&& func, uint32 minBatchSize = DEFAULT_PARALLEL_BATCH_SIZE)
+		{
+			ValidateQueryAccess<ComponentTypes...>();
+
+			IterateQueryParallel<ComponentTypes...>(GetCachedQueryState<ComponentTypes...>(), MakeChunkProcessor<ComponentTypes...>(func), minBatchSize);
+		}
+
+		/// @brief	`ForEachParallel` の既定の最小バッチサイズ (エンティティ数)
+		static constexpr uint32 DEFAULT_PARALLEL_BATCH_SIZE = 64;
+
+	private:
+		template <typename... ComponentTypes>
+		friend class Query;
+
+		template <typename T>
+		friend class ComponentLookup;
+
+		EntityManager entityManager;
+		ArchetypeManager archetypeManager;
+		SharedComponentStore sharedComponents;
+		ResourceStore resources;
+		ObserverRegistry observers;
+
+		// Compact を再開するアーキタイプの位置
+		size_t compactCursor = 0;
+
+		// ForEach用のクエリキャッシュ (型リスト -> 一致アーキタイプ)
+		std::unordered_map<std::type_index, std::unique_ptr<QueryStateBase>> queryCache;
+		std::mutex queryCacheMutex;
+
+		// システムの所有権リスト
+		std::vector<std::unique_ptr<System>> systems;
+
+		// 実行スケジュール (同じWave内のシステムは並列実行可能)
+		std::vector<std::vector<System*>> scheduleWaves;
+		bool isScheduleDirty = true;
+
+		/// @brief	スレッドで実行中のシステムと、その所属ワールド
+		struct ExecutingContext
+		{
+			const World* Owner;
+			System* Sys;
+		};
+
+		// 現在のスレッドで実行中のシステム (アクセス検証・変更バージョン用)
+		// システム内から別のワールドを操作した場合に、そのワールドへ持ち込まないよう所属ワールドも保持する
+		inline static thread_local ExecutingContext s_executing{ nullptr, nullptr };
+
+		// 変更バージョンの発行元 (システム実行ごとに加算)
+		std::atomic<uint32> globalVersion{ 1 };
+
+		// 構造的変更の回数 (統計用、UpdateSystems で前フレーム分へ移す)
+		std::atomic<uint64> structuralChanges{ 0 };
+		uint64 structuralChangesLastFrame = 0;
+
+		// 報告済みのアクセス違反 (同じ警告を毎フレーム出さないため)
+		std::set<std::pair<const System*, std::string>> reportedViolations;
+		std::mutex violationMutex;
+
+		// スレッドごとのコマンドバッファ ([0]: メイン, [1~N]: ワーカー)
+		std::vector<std::unique_ptr<EntityCommandBuffer>> commandBuffers;
+
+		// --- Internal Helper Methods ---
+
+		/// @brief	スレッドの実行中システムを一時的に差し替えるスコープ
+		struct ExecutingSystemScope
+		{
+			ExecutingContext Previous;
+			ExecutingSystemScope(const World* world, System* sys) : Previous(s_executing) { s_executing = { world, sys }; }
+			~ExecutingSystemScope() { s_executing = Previous; }
+		};
+
+		/// @brief	このワールドで実行中のシステムを取得します (他のワールドのシステム実行中は nullptr)
+		System* GetExecutingSystem() const
+		{
+			return (s_executing.Owner == this) ? s_executing.Sys : nullptr;
+		}
+
+		/**
+		 * @brief	削除で空になったチャンクを返却します。
+		 * @details	`ForEach` の中で削除されても走査中のチャンクが解放されないよう、返却は同期ポイントでのみ行います。
+		 */
+		void ReleaseEmptyChunks()
+		{
+			for (Archetype* archetype : archetypeManager.GetArchetypeList())
+			{
+				archetype->ReleaseEmptyChunks();
+			}
+		}
+
+		/// @brief	ジョブを実行し得る全スレッド分のコマンドバッファを用意します。
+		void PrepareCommandBuffers()
+		{
+			while (commandBuffers.size() < JobSystem::GetThreadCount())
+			{
+				commandBuffers.push_back(std::make_unique<EntityCommandBuffer>());
+			}
+		}
+
+		void RunSystem(System* sys)
 		{
-			EntityLocation oldLoc = entityLocationMap[entity.ID];
-			if (oldLoc.PtrArchetype == newArchetype) return;
+			ExecutingSystemScope scope(this, sys);
+
+			// 実行ごとに新しいバージョンを割り当て、書き込んだ列に記録させる
+			sys->currentVersion = globalVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+			sys->OnUpdate();
+			sys->lastRunVersion = sys->currentVersion;
+		}
+
+		/**
+		 * @brief	書き込み時にチャンクへ記録するバージョンを取得します。
+		 * @details	システム外 (エディタ等) からの書き込みは、次に実行されるシステムのバージョンとして記録します。
+		 */
+		uint32 GetWriteVersion() const
+		{
+			if (const System* sys = GetExecutingSystem()) return sys->currentVersion;
+			return globalVersion.load(std::memory_order_relaxed) + 1;
+		}
+
+		/// @brief	フィルターの基準バージョン (システム外からの走査では全チャンクが対象)
+		uint32 GetFilterVersion() const
+		{
+			if (const System* sys = GetExecutingSystem()) return sys->lastRunVersion;
+			return 0;
+		}
+
+		/**
+		 * @brief	システムのアクセス宣言から依存関係 (DAG) を構築し、Waveに分割します。
+		 * @details	各システムは、登録順で前にある競合システム全ての後ろのWaveに配置されます。
+		 */
+		void BuildSchedule()
+		{
+			const size_t count = systems.size();
+			std::vector<size_t> levels(count, 0);
+			size_t maxLevel = 0;
+
+			for (size_t j = 0; j < count; ++j)
+			{
+				const SystemAccess& access = systems[j]->GetAccess();
+				for (size_t i = 0; i < j; ++i)
+				{
+					// i -> j の依存辺: jはiより後のWaveで実行されなければならない
+					if (access.ConflictsWith(systems[i]->GetAccess()))
+					{
+						levels[j] = (std::max)(levels[j], levels[i] + 1);
+					}
+				}
+				maxLevel = (std::max)(maxLevel, levels[j]);
+			}
+
+			scheduleWaves.assign(count > 0 ? maxLevel + 1 : 0, {});
+			for (size_t i = 0; i < count; ++i)
+			{
+				scheduleWaves[levels[i]].push_back(systems[i].get());
+			}
+
+			isScheduleDirty = false;
+			SPAN_LOG("System schedule built: %zu systems in %zu waves", count, scheduleWaves.size());
+		}
+
+		/// @brief	クエリの型リスト全てについてアクセス宣言を検証します。
+		template <typename... ComponentTypes>
+		void ValidateQueryAccess()
+		{
+			// 関数に渡されない項目 (With / Without / Any) はデータにアクセスしない
+			((QueryTerm<ComponentTypes>::HasArgument ? ValidateAccess<typename QueryTerm<ComponentTypes>::AccessType>() : void()), ...);
+		}
+
+		/// @brief	実行中システムがコンポーネント `T` へのアクセスを宣言しているか検証します。
+		template <typename T>
+		void ValidateAccess()
+		{
+#if SPAN_ECS_VALIDATE_ACCESS
+			const System* sys = GetExecutingSystem();
+			if (!sys || !sys->GetAccess().IsDeclared) return;
+
+			constexpr bool isReadOnly = std::is_const_v<T>;
+			ComponentTypeID typeID = ComponentType<T>::GetID();
+			bool allowed = isReadOnly ? sys->GetAccess().CanRead(typeID) : sys->GetAccess().CanWrite(typeID);
+			if (!allowed)
+			{
+				ReportViolation(sys, std::string(isReadOnly ? "read " : "write ") + ComponentType<T>::GetName());
+			}
+#endif
+		}
+
+		/// @brief	構造的変更の回数を記録し、並列実行され得るシステム内での構造的変更を検出します。
+		void ValidateStructuralChange(const char* operation)
+		{
+			structuralChanges.fetch_add(1, std::memory_order_relaxed);
+
+#if SPAN_ECS_VALIDATE_ACCESS
+			const System* sys = GetExecutingSystem();
+			if (!sys || !sys->GetAccess().IsDeclared) return;
+
+			ReportViolation(sys, std::string("structural change: ") + operation);
+#else
+			(void)operation;
+#endif
+		}
+
+		void ReportViolation(const System* sys, const std::string& detail)
+		{
+			std::lock_guard<std::mutex> lock(violationMutex);
+			if (reportedViolations.insert({ sys, detail }).second)
+			{
+				SPAN_WARN("[ECS] System '%s' performed an undeclared access (%s)", sys->GetName(), detail.c_str());
+			}
+		}
+
+		// アーキタイプ間の移動 (共有コンポーネントの値は引き継ぐ)
+		void MigrateEntity(Entity entity, Archetype* newArchetype)
+		{
+			const EntityLocation& loc = entityManager.GetLocationByIndex(entity.ID.Index);
+			MigrateEntity(entity, newArchetype, CarrySharedValues(loc.PtrArchetype, loc.PtrChunk, newArchetype));
+		}
+
+		// アーキタイプ (または同じアーキタイプ内の、共有値の異なるチャンク) への移動
+		void MigrateEntity(Entity entity, Archetype* newArchetype, std::span<const uint32> sharedValues)
+		{
+			EntityLocation oldLoc = entityManager.GetLocationByIndex(entity.ID.Index);
+			if (oldLoc.PtrArchetype == newArchetype &&
+				std::equal(sharedValues.begin(), sharedValues.end(), oldLoc.PtrChunk->SharedValues.begin(), oldLoc.PtrChunk->SharedValues.end()))
+			{
+				return;
+			}
 
 			// 1. 新しい場所を確保
-			uint32 newIndex = newArchetype->AllocateEntity(entity.ID);
-			Chunk* newChunk = newArchetype->GetChunks().back();
+			uint32 newIndex = 0;
+			Chunk* newChunk = newArchetype->AllocateEntity(entity.ID, newIndex, sharedValues);
 
 			// 2. 共通のコンポーネントのデータをコピー
 			for (ComponentTypeID typeID : oldLoc.PtrArchetype->GetTypes())
 			{
 				if (newArchetype->HasComponent(typeID))
 				{
+					// 無効化状態も引き継ぐ
+					uint32 oldColumn = oldLoc.PtrArchetype->GetColumnIndex(typeID);
+					if (!oldLoc.PtrChunk->IsEnabled(oldColumn, oldLoc.IndexInChunk))
+					{
+						newChunk->SetEnabled(newArchetype->GetColumnIndex(typeID), newIndex, false);
+					}
+
+					// タグはデータを持たない
 					size_t size = oldLoc.PtrArchetype->GetComponentSize(typeID);
+					if (size == 0) continue;
+
 					size_t oldOffset = oldLoc.PtrArchetype->GetComponentOffset(typeID);
 					size_t newOffset = newArchetype->GetComponentOffset(typeID);
 
@@ -477,24 +1569,242 @@ namespace Span
 				}
 			}
 
-			// 3. 古い情報を削除 (Swap-back)
-			Chunk* oldChunk = oldLoc.PtrChunk;
-			uint32 lastIndex = oldChunk->Count - 1;
-			EntityID lastEntityID = reinterpret_cast<EntityID*>(oldChunk->Memory)[lastIndex];
+			// 3. 古い情報を削除 (Swap-back、空になったチャンクは同期ポイントで返却される)
+			const uint32 version = GetWriteVersion();
+			EntityID movedEntityID = oldLoc.PtrArchetype->RemoveEntity(oldLoc.PtrChunk, oldLoc.IndexInChunk);
+			if (movedEntityID != NullEntityID)
+			{
+				entityManager.GetLocationByIndex(movedEntityID.Index).IndexInChunk = oldLoc.IndexInChunk;
+				oldLoc.PtrChunk->MarkAllChanged(version);
+			}
+
+			// 4. 住所更新
+			entityManager.GetLocationByIndex(entity.ID.Index) = EntityLocation{ newArchetype, newChunk, newIndex };
+			observers.Record(oldLoc.PtrArchetype, newArchetype, std::span<const EntityID>(&entity.ID, 1));
+
+			// 5. 移動先チャンクは中身が変わったので全列を変更扱いにし、新しく増えた列は追加として記録
+			newChunk->MarkAllChanged(version);
+			const std::vector<ComponentTypeID>& newTypes = newArchetype->GetTypes();
+			for (uint32 column = 0; column < static_cast<uint32>(newTypes.size()); ++column)
+			{
+				if (!oldLoc.PtrArchetype->HasComponent(newTypes[column]))
+				{
+					newChunk->MarkAdded(column, version);
+				}
+			}
+		}
+
+		/// @brief	移動先アーキタイプの共有型の順に、移動元チャンクの共有値を並べ直します (新しい型の値は未設定)。
+		std::vector<uint32> CarrySharedValues(const Archetype* oldArchetype, const Chunk* oldChunk, const Archetype* newArchetype) const
+		{
+			const std::vector<ComponentTypeID>& newTypes = newArchetype->GetSharedTypes();
+			std::vector<uint32> values(newTypes.size(), SharedComponentStore::INVALID_INDEX);
+			for (size_t i = 0; i < newTypes.size(); ++i)
+			{
+				if (oldArchetype->HasComponent(newTypes[i]))
+				{
+					values[i] = oldChunk->SharedValues[oldArchetype->GetSharedIndex(newTypes[i])];
+				}
+			}
+			return values;
+		}
+
+		/// @brief	チャンクが保持する共有値の参照を手放します (エンティティ1体分)。
+		void ReleaseSharedValues(const Archetype* archetype, const Chunk* chunk)
+		{
+			const std::vector<ComponentTypeID>& sharedTypes = archetype->GetSharedTypes();
+			for (size_t i = 0; i < sharedTypes.size(); ++i)
+			{
+				sharedComponents.Release(sharedTypes[i], chunk->SharedValues[i]);
+			}
+		}
+
+		/// @brief	アーキタイプの列のうち、`memcpy` で複製できない列を列挙します。
+		static std::vector<WorldSnapshot::Column> GetSnapshotColumns(const Archetype* archetype)
+		{
+			std::vector<WorldSnapshot::Column> columns;
+			for (ComponentTypeID typeID : archetype->GetTypes())
+			{
+				size_t size = archetype->GetComponentSize(typeID);
+				if (size == 0) continue;
+
+				ComponentTypeOps ops = ComponentTypeRegistry::GetOps(typeID);
+				if (ops.Copy || ops.Destroy)
+				{
+					columns.push_back({ archetype->GetComponentOffset(typeID), size, ops });
+				}
+			}
+			return columns;
+		}
+
+		/// @brief	チャンクのメモリと列ごとの状態を複製します。
+		static void SaveChunk(const Chunk& chunk, WorldSnapshot::ChunkData& out, const std::vector<WorldSnapshot::Column>& columns)
+		{
+			out.Memory = static_cast<uint8*>(ChunkAllocator::Allocate(chunk.Size));
+			out.Count = chunk.Count;
+
+			// ブロックを丸ごとコピーし、複製関数を持つ列だけコピー構築し直す
+			memcpy(out.Memory, chunk.Memory, chunk.Size);
+			for (const WorldSnapshot::Column& column : columns)
+			{
+				if (column.Ops.Copy) column.Ops.Copy(out.Memory + column.Offset, chunk.Memory + column.Offset, chunk.Count);
+			}
+
+			out.SharedValues = chunk.SharedValues;
+			out.AddVersions.resize(chunk.AddVersions.size());
+			for (size_t i = 0; i < chunk.AddVersions.size(); ++i) out.AddVersions[i] = chunk.AddVersions[i].load(std::memory_order_relaxed);
+			out.EnabledBits.resize(chunk.EnabledBits.size());
+			for (size_t i = 0; i < chunk.EnabledBits.size(); ++i) out.EnabledBits[i] = chunk.EnabledBits[i].load(std::memory_order_relaxed);
+			out.DisabledCounts.resize(chunk.DisabledCounts.size());
+			for (size_t i = 0; i < chunk.DisabledCounts.size(); ++i) out.DisabledCounts[i] = chunk.DisabledCounts[i].load(std::memory_order_relaxed);
+		}
+
+		/// @brief	`SaveChunk` で複製した内容を、空のチャンクへ書き戻します。
+		static void LoadChunk(const WorldSnapshot::ChunkData& saved, Chunk& chunk, const std::vector<WorldSnapshot::Column>& columns)
+		{
+			chunk.Count = saved.Count;
+
+			memcpy(chunk.Memory, saved.Memory, chunk.Size);
+			for (const WorldSnapshot::Column& column : columns)
+			{
+				if (column.Ops.Copy) column.Ops.Copy(chunk.Memory + column.Offset, saved.Memory + column.Offset, saved.Count);
+			}
+
+			for (size_t i = 0; i < saved.AddVersions.size(); ++i) chunk.AddVersions[i].store(saved.AddVersions[i], std::memory_order_relaxed);
+			for (size_t i = 0; i < saved.EnabledBits.size(); ++i) chunk.EnabledBits[i].store(saved.EnabledBits[i], std::memory_order_relaxed);
+			for (size_t i = 0; i < saved.DisabledCounts.size(); ++i) chunk.DisabledCounts[i].store(saved.DisabledCounts[i], std::memory_order_relaxed);
+		}
+
+		/// @brief	別のワールドのアーキタイプと同じ構成のアーキタイプを取得します (無ければ同じ型の並びで作成)。
+		Archetype* GetOrCreateArchetypeLike(const Archetype& other)
+		{
+			const std::vector<ComponentTypeID>& types = other.GetTypes();
+			std::vector<size_t> sizes;
+			std::vector<size_t> aligns;
+			for (auto id : types)
+			{
+				sizes.push_back(other.GetComponentSize(id));
+				aligns.push_back(other.GetComponentAlignment(id));
+			}
+			return archetypeManager.GetOrCreateArchetype(types, sizes, aligns, other.GetSharedTypes());
+		}
+
+		/// @brief	移動元ワールドのチャンクが参照している共有値を、このワールドのストアへ移し替えます。
+		void TransferSharedValues(World& source, const Archetype* sourceArchetype, Chunk* chunk)
+		{
+			const std::vector<ComponentTypeID>& sharedTypes = sourceArchetype->GetSharedTypes();
+			for (size_t i = 0; i < sharedTypes.size(); ++i)
+			{
+				uint32 sourceIndex = chunk->SharedValues[i];
+				chunk->SharedValues[i] = sharedComponents.AcquireFrom(source.sharedComponents, sharedTypes[i], sourceIndex, chunk->Count);
+				source.sharedComponents.Release(sharedTypes[i], sourceIndex, chunk->Count);
+			}
+		}
+
+		/**
+		 * @brief	チャンク内の範囲のエンティティに、このワールドのIDを発行し直します。
+		 * @details	チャンクに書かれている移動元のIDは移動元ワールドで破棄され、新しいIDと住所に置き換えられます。
+		 */
+		void ReassignEntities(World& source, Chunk* chunk, uint32 startIndex, uint32 count, std::vector<std::pair<Entity, Entity>>* outRemap)
+		{
+			std::vector<Entity> entities(count);
+			entityManager.CreateEntities(count, entities.data());
+
+			EntityID* ids = reinterpret_cast<EntityID*>(chunk->Memory) + startIndex;
+			source.observers.Record(chunk->OwnerArchetype, nullptr, std::span<const EntityID>(ids, count));
+			for (uint32 i = 0; i < count; ++i)
+			{
+				Entity previous = { ids[i] };
+				source.entityManager.DestroyEntity(previous);
+				if (outRemap) outRemap->emplace_back(previous, entities[i]);
+
+				ids[i] = entities[i].ID;
+				entityManager.GetLocationByIndex(entities[i].ID.Index) = EntityLocation{ chunk->OwnerArchetype, chunk, startIndex + i };
+			}
+			observers.Record(nullptr, chunk->OwnerArchetype, std::span<const EntityID>(ids, count));
+		}
+
+		/// @brief	レイアウトの異なる移動元チャンクの中身を、列単位でこのワールドのアーキタイプへコピーします。
+		void CopyChunkInto(World& source, const Archetype* sourceArchetype, const Chunk* sourceChunk, Archetype* archetype, uint32 version, std::vector<std::pair<Entity, Entity>>* outRemap)
+		{
+			std::vector<uint32> sharedValues = CarrySharedValues(sourceArchetype, sourceChunk, archetype);
+			const EntityID* sourceIDs = reinterpret_cast<const EntityID*>(sourceChunk->Memory);
+
+			uint32 copied = 0;
+			while (copied < sourceChunk->Count)
+			{
+				uint32 startIndex = 0;
+				uint32 count = 0;
+				Chunk* chunk = archetype->AllocateRange(sourceChunk->Count - copied, startIndex, count, sharedValues);
+
+				for (ComponentTypeID typeID : sourceArchetype->GetTypes())
+				{
+					// 無効化状態も引き継ぐ
+					uint32 sourceColumn = sourceArchetype->GetColumnIndex(typeID);
+					uint32 column = archetype->GetColumnIndex(typeID);
+					if (sourceChunk->HasDisabled(sourceColumn))
+					{
+						for (uint32 i = 0; i < count; ++i)
+						{
+							if (!sourceChunk->IsEnabled(sourceColumn, copied + i)) chunk->SetEnabled(column, startIndex + i, false);
+						}
+					}
+
+					size_t size = sourceArchetype->GetComponentSize(typeID);
+					if (size == 0) continue;
+
+					const uint8* src = sourceChunk->Memory + sourceArchetype->GetComponentOffset(typeID) + copied * size;
+					uint8* dst = chunk->Memory + archetype->GetComponentOffset(typeID) + startIndex * size;
+					memcpy(dst, src, size * count);
+				}
+
+				// 移動元のIDを書き込んでから発行し直す
+				std::copy_n(sourceIDs + copied, count, reinterpret_cast<EntityID*>(chunk->Memory) + startIndex);
+				ReassignEntities(source, chunk, startIndex, count, outRemap);
+				chunk->MarkAllAdded(version);
+
+				copied += count;
+			}
+		}
+
+		/// @brief	共有コンポーネントを1つ加えた (または除いた) 遷移先アーキタイプを取得します。
+		Archetype* GetSharedTransition(Archetype* oldArchetype, ComponentTypeID sharedID, bool add)
+		{
+			Archetype* newArchetype = add ? oldArchetype->GetAddEdge(sharedID) : oldArchetype->GetRemoveEdge(sharedID);
+			if (newArchetype) return newArchetype;
 
-			if (oldLoc.IndexInChunk != lastIndex)
+			// 通常のコンポーネント構成はそのまま
+			const std::vector<ComponentTypeID>& types = oldArchetype->GetTypes();
+			std::vector<size_t> sizes;
+			std::vector<size_t> aligns;
+			for (auto id : types)
 			{
-				oldChunk->MoveEntityData(oldLoc.PtrArchetype, lastIndex, oldLoc.IndexInChunk);
-				entityLocationMap[lastEntityID].IndexInChunk = oldLoc.IndexInChunk;
+				sizes.push_back(oldArchetype->GetComponentSize(id));
+				aligns.push_back(oldArchetype->GetComponentAlignment(id));
 			}
-			oldChunk->Count--;
 
-			// 4. マップ更新
-			EntityLocation newLoc{ newArchetype, newChunk, newIndex };
-			entityLocationMap[entity.ID] = newLoc;
+			std::vector<ComponentTypeID> sharedTypes = oldArchetype->GetSharedTypes();
+			if (add) sharedTypes.push_back(sharedID);
+			else sharedTypes.erase(std::remove(sharedTypes.begin(), sharedTypes.end(), sharedID), sharedTypes.end());
+
+			newArchetype = archetypeManager.GetOrCreateArchetype(types, sizes, aligns, sharedTypes);
+
+			// 双方向の辺をキャッシュ
+			if (add)
+			{
+				oldArchetype->SetAddEdge(sharedID, newArchetype);
+				newArchetype->SetRemoveEdge(sharedID, oldArchetype);
+			}
+			else
+			{
+				oldArchetype->SetRemoveEdge(sharedID, newArchetype);
+				newArchetype->SetAddEdge(sharedID, oldArchetype);
+			}
+			return newArchetype;
 		}
 
 		// ヘルパー: Locationからコンポーネント参照を解決
+		// (タグはチャンク先頭を指すダミーの参照になるが、メンバを持たないため読み書きは発生しない)
 		template <typename T>
 		T& GetComponentUnsafe(const EntityLocation& loc)
 		{
@@ -514,36 +1824,288 @@ namespace Span
 		template <typename T>
 		void InitializeComponent(const EntityLocation& loc)
 		{
-			T& val = GetComponentUnsafe<T>(loc);
-			new (&val) T();
+			if constexpr (!ComponentType<T>::IsTag)
+			{
+				T& val = GetComponentUnsafe<T>(loc);
+				new (&val) T();
+			}
+		}
+
+		/// @brief	チャンク内の連続した範囲をまとめて初期化し、そのカラムを返します。
+		template <typename T>
+		std::span<T> InitializeColumn(Archetype* archetype, Chunk* chunk, uint32 startIndex, uint32 count)
+		{
+			size_t offset = archetype->GetComponentOffset(ComponentType<T>::GetID());
+			T* column = reinterpret_cast<T*>(chunk->Memory + offset) + startIndex;
+			if constexpr (!ComponentType<T>::IsTag)
+			{
+				std::uninitialized_value_construct_n(column, count);
+			}
+			return std::span<T>(column, count);
+		}
+
+		/**
+		 * @brief	`ForEach` 用のキャッシュ済みクエリ状態を取得し、最新の状態に更新します。
+		 *
+		 * @details
+		 * 並列実行中のシステムからも呼ばれるため、キャッシュの参照・更新はロックして行います。
+		 * 返した状態はロック外で走査されるため、並列実行のWaveの前に `UpdateCachedQueryStates` で全て最新にしておきます
+		 * (並列実行中はアーキタイプが生成されないため、既存の状態の `Matches` は書き換わりません)。
+		 */
+		template <typename... ComponentTypes>
+		QueryState<ComponentTypes...>& GetCachedQueryState()
+		{
+			std::lock_guard<std::mutex> lock(queryCacheMutex);
+
+			std::unique_ptr<QueryStateBase>& entry = queryCache[std::type_index(typeid(QueryState<ComponentTypes...>))];
+			if (!entry)
+			{
+				entry = std::make_unique<QueryState<ComponentTypes...>>();
+			}
+
+			auto& state = static_cast<QueryState<ComponentTypes...>&>(*entry);
+			state.Update(archetypeManager);
+			return state;
+		}
+
+		/// @brief	キャッシュ済みの全てのクエリ状態を、現在のアーキタイプに合わせて更新します (メインスレッド専用)。
+		void UpdateCachedQueryStates()
+		{
+			std::lock_guard<std::mutex> lock(queryCacheMutex);
+			for (auto& [type, state] : queryCache)
+			{
+				state->Update(archetypeManager);
+			}
+		}
+
+		/**
+		 * @brief	クエリ状態に一致した全チャンクを順番に処理します。
+		 * @param	chunkFunc `(Chunk* chunk, const Match& match)` を受け取るチャンク単位の処理
+		 */
+		template <typename... ComponentTypes, typename ChunkFunc>
+		void IterateQuery(const QueryState<ComponentTypes...>& state, ChunkFunc&& chunkFunc)
+		{
+			const uint32 filterVersion = GetFilterVersion();
+			const uint32 writeVersion = GetWriteVersion();
+
+			// ループ中にアーキタイプが追加されても破綻しないよう、インデックスで走査する
+			for (size_t i = 0; i < state.Matches.size(); ++i)
+			{
+				const auto match = state.Matches[i];
+				for (Chunk* chunk : match.PtrArchetype->GetChunks())
+				{
+					if (chunk->Count == 0) continue;
+
+					// 変化の無いチャンクは丸ごとスキップ
+					if (!QueryState<ComponentTypes...>::PassesFilters(chunk, match, filterVersion)) continue;
+					QueryState<ComponentTypes...>::MarkWrites(chunk, match, writeVersion);
+
+					chunkFunc(chunk, match);
+				}
+			}
+		}
+
+		/**
+		 * @brief	クエリ状態に一致したチャンクをバッチに分け、並列に処理します。
+		 * @param	chunkFunc `(Chunk* chunk, const Match& match)` を受け取るチャンク単位の処理 (複数スレッドから呼ばれます)
+		 */
+		template <typename... ComponentTypes, typename ChunkFunc>
+		void IterateQueryParallel(const QueryState<ComponentTypes...>& state, ChunkFunc&& chunkFunc, uint32 minBatchSize)
+		{
+			using Match = typename QueryState<ComponentTypes...>::Match;
+
+			struct ChunkTask
+			{
+				Chunk* PtrChunk;
+				const Match* PtrMatch;
+			};
+
+			// ジョブ内から GetCommandBuffer が呼ばれても配列が伸びないように
+			PrepareCommandBuffers();
+
+			// 1. 対象チャンクを列挙 (変化の無いチャンクは除外し、書き込む列にはここでバージョンを記録)
+			const uint32 filterVersion = GetFilterVersion();
+			const uint32 writeVersion = GetWriteVersion();
+
+			std::vector<ChunkTask> tasks;
+			uint32 totalEntities = 0;
+
+			for (const Match& match : state.Matches)
+			{
+				for (Chunk* chunk : match.PtrArchetype->GetChunks())
+				{
+					if (chunk->Count == 0) continue;
+					if (!QueryState<ComponentTypes...>::PassesFilters(chunk, match, filterVersion)) continue;
+
+					QueryState<ComponentTypes...>::MarkWrites(chunk, match, writeVersion);
+					tasks.push_back({ chunk, &match });
+					totalEntities += chunk->Count;
+				}
+			}
+
+			if (tasks.empty()) return;
+
+			// 2. エンティティ数が minBatchSize 以上になるようにチャンクをまとめる
+			uint32 targetBatches = JobSystem::GetThreadCount() * 4;
+			uint32 batchEntities = (std::max)(minBatchSize, (totalEntities + targetBatches - 1) / targetBatches);
+
+			std::vector<uint32> batchStarts;	///< 各バッチの先頭タスク番号
+			uint32 accumulated = batchEntities;
+			for (uint32 i = 0; i < static_cast<uint32>(tasks.size()); ++i)
+			{
+				if (accumulated >= batchEntities)
+				{
+					batchStarts.push_back(i);
+					accumulated = 0;
+				}
+				accumulated += tasks[i].PtrChunk->Count;
+			}
+			batchStarts.push_back(static_cast<uint32>(tasks.size()));
+
+			// 3. バッチ単位で並列実行 (ワーカー上でも呼び出し元システムのアクセス検証を引き継ぐ)
+			System* owner = GetExecutingSystem();
+			JobSystem::ParallelFor(static_cast<uint32>(batchStarts.size() - 1), 1, [&](uint32 begin, uint32 end)
+			{
+				ExecutingSystemScope scope(this, owner);
+				for (uint32 batch = begin; batch < end; ++batch)
+				{
+					for (uint32 t = batchStarts[batch]; t < batchStarts[batch + 1]; ++t)
+					{
+						chunkFunc(tasks[t].PtrChunk, *tasks[t].PtrMatch);
+					}
+				}
+			});
+		}
+
+		/// @brief	エンティティごとに関数を呼び出すチャンク処理を作成します (`ForEach` 用)。
+		template <typename... ComponentTypes, typename Func>
+		auto MakeEntityProcessor(Func& func)
+		{
+			return [this, &func](Chunk* chunk, const typename QueryState<ComponentTypes...>::Match& match)
+			{
+				ProcessChunk<ComponentTypes...>(chunk, match, func);
+			};
+		}
+
+		/// @brief	チャンクごとに `ChunkView` を渡すチャンク処理を作成します (`ForEachChunk` 用)。
+		template <typename... ComponentTypes, typename Func>
+		auto MakeChunkProcessor(Func& func)
+		{
+			using State = QueryState<ComponentTypes...>;
+			using Match = typename State::Match;
+
+			return [this, &func](Chunk* chunk, const Match& match)
+			{
+				ChunkView::EnabledMaskFunc enabledMask = [](const Chunk* c, const void* m, uint32 word)
+				{
+					return State::GetEnabledWord(c, *static_cast<const Match*>(m), word);
+				};
+				func(ChunkView(chunk, &sharedComponents, State::HasDisabled(chunk, match), enabledMask, &State::IsWriteColumn, &match));
+			};
 		}
 
 		// --- ヘルパー関数 ---
 		template <typename... ComponentTypes, typename Func, size_t... Indices>
-		void ProcessChunk_Impl(Chunk* chunk, uint32 count, const std::tuple<decltype(sizeof(ComponentTypes))...>& offsets, Func&& func, std::index_sequence<Indices...>)
+		void ProcessChunk_Impl(Chunk* chunk, const typename QueryState<ComponentTypes...>::Match& match, Func&& func, std::index_sequence<Indices...>)
 		{
-			// 各コンポーネント配列の先頭アドレスを取得
-			std::tuple<ComponentTypes*...> arrays = std::make_tuple(
-				reinterpret_cast<ComponentTypes*>(chunk->Memory + std::get<Indices>(offsets))...
+			// 各コンポーネント配列の先頭アドレスを取得 (共有コンポーネントはチャンクで1つの値)
+			std::tuple<typename QueryTerm<ComponentTypes>::Component*...> arrays = std::make_tuple(
+				GetTermData<ComponentTypes>(chunk, std::get<Indices>(match.Offsets), match.Columns[Indices])...
 			);
 
 			// EntityID配列へのポインタ
 			EntityID* entityIDs = reinterpret_cast<EntityID*>(chunk->Memory);
+			const uint32 count = chunk->Count;
 
-			// チャンク内ループ
-			for (uint32 i = 0; i < count; ++i)
+			// 無効化されたエンティティが無ければ、そのまま全件ループ
+			if (!QueryState<ComponentTypes...>::HasDisabled(chunk, match))
+			{
+				for (uint32 i = 0; i < count; ++i)
+				{
+					Entity entity = { entityIDs[i] };
+
+					// ユーザー関数を実行: func(entity, compA[i], compB[i]...)
+					InvokeTerms<ComponentTypes...>(func, entity, arrays, i, std::index_sequence<Indices...>{});
+				}
+				return;
+			}
+
+			// 64体ずつ有効ビットのANDを取り、立っているビットだけを処理する
+			const uint32 wordCount = (count + 63) / 64;
+			for (uint32 word = 0; word < wordCount; ++word)
+			{
+				uint64 bits = QueryState<ComponentTypes...>::GetEnabledWord(chunk, match, word);
+				uint32 remaining = count - word * 64;
+				if (remaining < 64) bits &= (1ull << remaining) - 1;
+
+				while (bits)
+				{
+					uint32 i = word * 64 + static_cast<uint32>(std::countr_zero(bits));
+					bits &= bits - 1;
+
+					Entity entity = { entityIDs[i] };
+					InvokeTerms<ComponentTypes...>(func, entity, arrays, i, std::index_sequence<Indices...>{});
+				}
+			}
+		}
+
+		/// @brief	クエリ項目のデータの先頭 (通常はコンポーネント配列、`Shared<T>` は共有値、列が無ければ `nullptr`) を取得します。
+		template <typename Term>
+		typename QueryTerm<Term>::Component* GetTermData(Chunk* chunk, size_t offset, uint32 column)
+		{
+			using Component = typename QueryTerm<Term>::Component;
+			if constexpr (!QueryTerm<Term>::HasArgument)
+			{
+				return nullptr;
+			}
+			else if constexpr (QueryTerm<Term>::IsShared)
+			{
+				return &sharedComponents.Get<std::remove_const_t<Component>>(chunk->SharedValues[column]);
+			}
+			else if constexpr (QueryTerm<Term>::IsOptional)
+			{
+				return (column != QueryStateBase::INVALID_COLUMN) ? reinterpret_cast<Component*>(chunk->Memory + offset) : nullptr;
+			}
+			else
 			{
-				Entity entity = { entityIDs[i] };
+				return reinterpret_cast<Component*>(chunk->Memory + offset);
+			}
+		}
 
-				// ユーザー関数を実行: func(entity, compA[i], compB[i]...)
-				func(entity, (std::get<Indices>(arrays)[i])...);
+		/// @brief	クエリ項目の i 番目の引数を、0個または1個の要素を持つタプルとして取得します。
+		template <typename Term>
+		static auto GetTermArgument(typename QueryTerm<Term>::Component* data, uint32 i)
+		{
+			using Component = typename QueryTerm<Term>::Component;
+			if constexpr (!QueryTerm<Term>::HasArgument)
+			{
+				return std::tuple<>();
+			}
+			else if constexpr (QueryTerm<Term>::IsOptional)
+			{
+				return std::tuple<Component*>(data ? data + i : nullptr);
+			}
+			else if constexpr (QueryTerm<Term>::IsShared)
+			{
+				return std::tuple<Component&>(*data);
+			}
+			else
+			{
+				return std::tuple<Component&>(data[i]);
 			}
 		}
 
+		/// @brief	i 番目のエンティティについて、関数に渡す項目だけを並べて呼び出します。
+		template <typename... ComponentTypes, typename Func, typename Arrays, size_t... Indices>
+		static void InvokeTerms(Func& func, Entity entity, const Arrays& arrays, uint32 i, std::index_sequence<Indices...>)
+		{
+			std::apply(func, std::tuple_cat(std::tuple<Entity>(entity), GetTermArgument<ComponentTypes>(std::get<Indices>(arrays), i)...));
+		}
+
 		template <typename... ComponentTypes, typename Func>
-		void ProcessChunk(Chunk* chunk, uint32 count, const std::tuple<decltype(sizeof(ComponentTypes))...>& offsets, Func&& func)
+		void ProcessChunk(Chunk* chunk, const typename QueryState<ComponentTypes...>::Match& match, Func&& func)
 		{
-			ProcessChunk_Impl<ComponentTypes...>(chunk, count, offsets, func, std::index_sequence_for<ComponentTypes...>{});
+			ProcessChunk_Impl<ComponentTypes...>(chunk, match, func, std::index_sequence_for<ComponentTypes...>{});
 		}
 	};
 }
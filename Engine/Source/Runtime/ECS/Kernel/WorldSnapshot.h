@@ -0,0 +1,111 @@
+﻿/*****************************************************************//**
+ * @file	WorldSnapshot.h
+ * @brief	ワールド全体の状態の複製 (スナップショット)。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "EntityManager.h"
+#include "SharedComponentStore.h"
+#include "ResourceStore.h"
+#include "Chunk.h"
+
+namespace Span
+{
+	class World;
+
+	/**
+	 * @class	WorldSnapshot
+	 * @brief	📸 `World::Snapshot` で保存したワールドの状態。`World::Restore` で元に戻せます。
+	 *
+	 * @details
+	 * チャンクのメモリ (ブロック単位)、エンティティの世代番号と住所録、共有コンポーネントとリソースの値をそのまま複製します。
+	 * `memcpy` で複製できない型は `ComponentTypeOps` の複製関数でコピーされ、
+	 * スナップショットの破棄時にデストラクタが呼ばれます。
+	 *
+	 * スナップショットは保存元のワールドにのみ復元できます。
+	 * 同じインスタンスに繰り返し保存すると、世代番号・住所録の配列の領域が再利用されます (ロールバック用)。
+	 *
+	 * ### 📝 Usage
+	 * ```cpp
+	 * WorldSnapshot editState;
+	 * world.Snapshot(editState);	// Play開始
+	 * ...
+	 * world.Restore(editState);	// Play終了
+	 * ```
+	 */
+	class WorldSnapshot
+	{
+	public:
+		WorldSnapshot() = default;
+		~WorldSnapshot() { Clear(); }
+
+		SPAN_NON_COPYABLE(WorldSnapshot);
+
+		/// @brief	保存した内容を破棄します。
+		void Clear()
+		{
+			for (ArchetypeData& archetype : archetypes)
+			{
+				for (ChunkData& chunk : archetype.Chunks)
+				{
+					for (const Column& column : archetype.Columns)
+					{
+						if (column.Ops.Destroy) column.Ops.Destroy(chunk.Memory + column.Offset, chunk.Count);
+					}
+					ChunkAllocator::Free(chunk.Memory);
+				}
+			}
+			archetypes.clear();
+			owner = nullptr;
+		}
+
+		/// @brief	状態が保存されているか
+		bool IsValid() const { return owner != nullptr; }
+
+		/// @brief	保存したエンティティ数
+		size_t GetEntityCount() const { return entities.ActiveCount; }
+
+	private:
+		friend class World;
+
+		/// @brief	`memcpy` で複製できない列
+		struct Column
+		{
+			size_t Offset;
+			size_t Size;
+			ComponentTypeOps Ops;
+		};
+
+		/// @brief	チャンク1つ分の複製
+		struct ChunkData
+		{
+			uint8* Memory = nullptr;			///< `ChunkAllocator` のブロック
+			uint32 Count = 0;
+			std::vector<uint32> SharedValues;
+			std::vector<uint32> AddVersions;
+			std::vector<uint64> EnabledBits;
+			std::vector<uint32> DisabledCounts;
+		};
+
+		/// @brief	アーキタイプ1つ分の複製
+		struct ArchetypeData
+		{
+			Archetype* PtrArchetype = nullptr;
+			std::vector<Column> Columns;
+			std::vector<ChunkData> Chunks;
+		};
+
+		const World* owner = nullptr;			///< 保存元のワールド
+		std::vector<ArchetypeData> archetypes;	///< 保存時のアーキタイプ (生成順)
+		EntityManager::Snapshot entities;
+		SharedComponentStore sharedComponents;
+		ResourceStore resources;
+	};
+}
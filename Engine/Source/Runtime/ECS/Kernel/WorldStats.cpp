@@ -0,0 +1,64 @@
+﻿#include "WorldStats.h"
+
+namespace Span
+{
+	namespace
+	{
+		/// @brief	JSONの文字列リテラルとして追記します (型名に含まれ得る記号をエスケープ)。
+		void AppendString(std::string& out, const std::string& value)
+		{
+			out += '"';
+			for (char c : value)
+			{
+				if (c == '"' || c == '\\') out += '\\';
+				if (static_cast<unsigned char>(c) < 0x20) continue;
+				out += c;
+			}
+			out += '"';
+		}
+
+		template <typename... Args>
+		void AppendFormat(std::string& out, const char* format, Args... args)
+		{
+			char buffer[128];
+			const int length = snprintf(buffer, sizeof(buffer), format, args...);
+			if (length > 0) out.append(buffer, (std::min)(static_cast<size_t>(length), sizeof(buffer) - 1));
+		}
+	}
+
+	std::string WorldStats::ToJson(uint32 maxArchetypes) const
+	{
+		// ECSのコアは外部ライブラリに依存させない (ヘッドレスのベンチマークでも使用する) ため、手書きで出力する
+		std::string json;
+		json.reserve(256 + Archetypes.size() * 256);
+
+		AppendFormat(json, "{\"entityCount\":%u,\"archetypeCount\":%u,\"chunkCount\":%u,", EntityCount, ArchetypeCount, ChunkCount);
+		AppendFormat(json, "\"allocatedBytes\":%zu,\"paddingBytes\":%zu,\"unusedBytes\":%zu,", AllocatedBytes, PaddingBytes, UnusedBytes);
+		AppendFormat(json, "\"structuralChangesLastFrame\":%llu,\"structuralChangesThisFrame\":%llu,",
+			static_cast<unsigned long long>(StructuralChangesLastFrame), static_cast<unsigned long long>(StructuralChangesThisFrame));
+
+		json += "\"archetypes\":[";
+		const size_t count = (std::min)(Archetypes.size(), static_cast<size_t>(maxArchetypes));
+		for (size_t i = 0; i < count; ++i)
+		{
+			const ArchetypeStats& archetype = Archetypes[i];
+			if (i > 0) json += ',';
+
+			json += "{\"components\":[";
+			for (size_t j = 0; j < archetype.Types.size(); ++j)
+			{
+				if (j > 0) json += ',';
+				AppendString(json, ComponentTypeRegistry::GetName(archetype.Types[j]));
+			}
+			json += "],";
+
+			AppendFormat(json, "\"chunkCount\":%u,\"chunkSize\":%zu,\"chunkCapacity\":%u,\"entityCount\":%u,\"fillRatio\":%.4f,",
+				archetype.ChunkCount, archetype.ChunkSize, archetype.ChunkCapacity, archetype.EntityCount, archetype.FillRatio);
+			AppendFormat(json, "\"entitySize\":%zu,\"allocatedBytes\":%zu,\"paddingBytes\":%zu,\"unusedBytes\":%zu,\"bytesPerEntity\":%.2f}",
+				archetype.EntitySize, archetype.AllocatedBytes, archetype.PaddingBytes, archetype.UnusedBytes, archetype.BytesPerEntity);
+		}
+		json += "]}";
+
+		return json;
+	}
+}
@@ -0,0 +1,69 @@
+﻿/*****************************************************************//**
+ * @file	WorldStats.h
+ * @brief	ワールドのメモリ使用量・チャンク充填率の統計。
+ *
+ * @details
+ *
+ * ------------------------------------------------------------
+ * @author	Iwai Shogo
+ * ------------------------------------------------------------
+ *********************************************************************/
+
+#pragma once
+#include "Core/CoreMinimal.h"
+#include "ECS/Internal/ComponentType.h"
+
+namespace Span
+{
+	/**
+	 * @struct	ArchetypeStats
+	 * @brief	📊 アーキタイプ1つ分のメモリ使用状況。
+	 */
+	struct ArchetypeStats
+	{
+		std::vector<ComponentTypeID> Types;	///< 構成コンポーネント (共有コンポーネントを含む)
+		uint32 ChunkCount = 0;				///< 確保しているチャンク数
+		size_t ChunkSize = 0;				///< 1チャンクのメモリサイズ (16KB / 64KB / 256KB)
+		uint32 ChunkCapacity = 0;			///< 1チャンクに格納できるエンティティ数 (レイアウト計算の結果)
+		uint32 EntityCount = 0;				///< 格納しているエンティティ数
+		float FillRatio = 0.0f;				///< 充填率 (EntityCount / (ChunkCount * ChunkCapacity))
+		size_t EntitySize = 0;				///< エンティティ1体分のデータサイズ (EntityIDを含む)
+		size_t AllocatedBytes = 0;			///< 確保しているチャンクの合計サイズ
+		size_t PaddingBytes = 0;			///< レイアウト上使われない領域 (列の境界揃え・チャンク末尾の余り) の合計
+		size_t UnusedBytes = 0;				///< 空きスロット (未使用のエンティティ枠) の合計
+		double BytesPerEntity = 0.0;		///< エンティティ1体あたりの実際の消費量 (AllocatedBytes / EntityCount)
+	};
+
+	/**
+	 * @struct	WorldStats
+	 * @brief	📊 `World::GetStats` で取得するワールド全体の統計。
+	 *
+	 * @details
+	 * `Archetypes` はメモリ使用量 (`AllocatedBytes`) の多い順に並んでいるため、先頭から見れば上位のアーキタイプが分かります。
+	 * 構造的変更の回数は `World::UpdateSystems` の呼び出しを1フレームとして数えます
+	 * (`CreateEntities` などの一括操作は1回として数えます)。
+	 *
+	 * `ToJson` で出力した内容を自動テストで比較すれば、
+	 * 大きなコンポーネントの追加による `ChunkCapacity` の低下などのレイアウトの退行を検出できます。
+	 */
+	struct WorldStats
+	{
+		uint32 EntityCount = 0;					///< 生存しているエンティティ数
+		uint32 ArchetypeCount = 0;				///< アーキタイプ数
+		uint32 ChunkCount = 0;					///< 全アーキタイプのチャンク数
+		size_t AllocatedBytes = 0;				///< 全チャンクの合計サイズ
+		size_t PaddingBytes = 0;				///< 全アーキタイプの `PaddingBytes` の合計
+		size_t UnusedBytes = 0;					///< 全アーキタイプの `UnusedBytes` の合計
+		uint64 StructuralChangesLastFrame = 0;	///< 前フレームの構造的変更の回数
+		uint64 StructuralChangesThisFrame = 0;	///< 現在のフレームで、これまでに行われた構造的変更の回数
+
+		std::vector<ArchetypeStats> Archetypes;	///< アーキタイプごとの統計 (メモリ使用量の多い順)
+
+		/**
+		 * @brief	JSON文字列に変換します。
+		 * @param	maxArchetypes 出力するアーキタイプの上限 (メモリ使用量の上位から)
+		 * @return	JSON文字列 (コンポーネントは型名で出力)
+		 */
+		std::string ToJson(uint32 maxArchetypes = UINT32_MAX) const;
+	};
+}
@@ -45,6 +45,11 @@ namespace Span
 	class RelationshipSystem : public System
 	{
 	public:
+		void OnCreate() override
+		{
+			DeclareWrite<Relationship>();
+		}
+
 		/**
 		 * @brief	指定したエンティティを現在の親から切断し、孤立させます。
 		 * @param	world ワールドポインタ
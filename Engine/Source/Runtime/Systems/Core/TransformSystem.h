@@ -12,6 +12,8 @@
 #pragma once
 #include "ECS/Kernel/System.h"
 #include "ECS/Kernel/World.h"
+#include "ECS/Kernel/Query.h"
+#include "ECS/Kernel/ComponentLookup.h"
 
 // Components
 #include "Components/Core/Transform.h"
@@ -34,10 +36,48 @@ namespace Span
 	class TransformSystem : public System
 	{
 	public:
+		void OnCreate() override
+		{
+			DeclareRead<Transform, Relationship>();
+			DeclareWrite<LocalToWorld>();
+
+			m_query = Query<const Transform, LocalToWorld>(GetWorld());
+			m_changedTransforms = Query<Changed<const Transform>>(GetWorld());
+			m_changedRelationships = Query<Changed<const Relationship>>(GetWorld());
+			m_transforms = ComponentLookup<const Transform>(GetWorld());
+			m_relationships = ComponentLookup<const Relationship>(GetWorld());
+
+			// 親の破棄や親子関係の解除は Changed フィルタに現れない (Swap-back で移動した側も変更扱いにならない) ため、
+			// 削除通知で再計算が必要なことを記録する
+			auto markDirty = [this](World&, std::span<const Entity>) { m_structureDirty = true; };
+			m_removeObservers[0] = GetWorld()->Observe<Transform>(ObserverEvent::OnRemove, markDirty);
+			m_removeObservers[1] = GetWorld()->Observe<Relationship>(ObserverEvent::OnRemove, markDirty);
+		}
+
+		void OnDestroy() override
+		{
+			for (ObserverID id : m_removeObservers)
+			{
+				GetWorld()->RemoveObserver(id);
+			}
+		}
+
 		void OnUpdate() override
 		{
-			GetWorld()->ForEach<Transform, LocalToWorld>(
-				[&](Entity entity, Transform&, LocalToWorld& ltw)
+			// 親の変更は子の行列にも波及するため、変更が1つでもあれば全体を再計算する
+			// (何も動いていないフレームは丸ごとスキップ)
+			// NOTE: フレームをまたいで保持した `Transform&` 経由の書き込みはバージョンが更新されないため検出できません。
+			//       書き込みは毎フレーム `GetComponent` / クエリから取得した参照で行ってください。
+			if (!m_structureDirty && m_changedTransforms.IsEmpty() && m_changedRelationships.IsEmpty()) return;
+			m_structureDirty = false;
+
+			// 親を辿る参照のオフセット表を更新 (ジョブ内からは読み取りのみ)
+			m_transforms.Update();
+			m_relationships.Update();
+
+			// 各エンティティは自分の LocalToWorld にしか書き込まないため、チャンク単位で並列実行できる
+			m_query.ForEachParallel(
+				[&](Entity entity, const Transform&, LocalToWorld& ltw)
 				{
 					// 行列計算
 					ltw.Value = ComputeWorldMatrix(entity);
@@ -46,6 +86,14 @@ namespace Span
 		}
 
 	private:
+		Query<const Transform, LocalToWorld> m_query;
+		Query<Changed<const Transform>> m_changedTransforms;
+		Query<Changed<const Relationship>> m_changedRelationships;
+		ComponentLookup<const Transform> m_transforms;
+		ComponentLookup<const Relationship> m_relationships;
+		ObserverID m_removeObservers[2] = {};
+		bool m_structureDirty = true;	///< Transform / Relationship が削除された (次回の更新で全体を再計算する)
+
 		/**
 		 * @brief	再帰的に親のワールド行列を取得し、自信のローカル行列と合成します。
 		 * @note
@@ -53,18 +101,16 @@ namespace Span
 		 * 階層が深い場合やオブジェクト数が多い場合、計算結果のキャッシュや
 		 * 階層順のソート (Dirty Flag方式) による最適化が将来的に必要になります。
 		 */
-		Matrix4x4 ComputeWorldMatrix(Entity entity)
+		Matrix4x4 ComputeWorldMatrix(Entity entity) const
 		{
-			World* world = GetWorld();
-
 			// 1. 自身のローカル行列 (T * R * S)
-			Transform* t = world->GetComponentPtr<Transform>(entity);
+			const Transform* t = m_transforms.GetPtr(entity);
 			if (!t) return Matrix4x4::Identity();
 
 			Matrix4x4 localMat = Matrix4x4::TRS(t->Position, t->Rotation, t->Scale);
 
 			// 2. 親がいるか確認
-			if (Relationship* rel = world->GetComponentPtr<Relationship>(entity))
+			if (const Relationship* rel = m_relationships.GetPtr(entity))
 			{
 				if (!rel->Parent.IsNull())
 				{
@@ -25,7 +25,7 @@ namespace Span
 	 * @details
 	 * `Camera` コンポーネントを持つエンティティの `LocalToWorld` を元にビュー行列 (逆行列) を作成し、
 	 * ウィンドウのアスペクト比に合わせて投影行列を作成します。
-	 * 計算結果は `Renderer` に送信されます。
+	 * 計算結果は `Renderer` に送信され、`ActiveCamera` リソースとしてワールドにも設定されます。
 	 */
 	class CameraSystem : public System
 	{
@@ -63,6 +63,10 @@ namespace Span
 
 					// 3. レンダラーに適用
 					renderer.SetCamera(viewMatrix, projMatrix);
+
+					// 4. 他のシステムから参照できるように公開
+					const Matrix4x4& worldMatrix = ltw.Value;
+					GetWorld()->SetResource(ActiveCamera{ viewMatrix, projMatrix, Vector3(worldMatrix.m[3][0], worldMatrix.m[3][1], worldMatrix.m[3][2]) });
 				}
 			);
 		}
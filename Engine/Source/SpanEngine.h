@@ -8,8 +8,10 @@
 #include "Core/Containers/FixedString.h"
 #include "Core/CoreMinimal.h"
 #include "Core/Input/Input.h"
+#include "Core/Jobs/JobSystem.h"
 #include "Core/Log/Logger.h"
 #include "Core/Math/SpanMath.h"
+#include "Core/Memory/ChunkAllocator.h"
 #include "Core/Memory/MemoryArena.h"
 #include "Core/Time/Time.h"
 #include "Runtime/Application.h"
@@ -31,11 +33,22 @@
 #include "Runtime/ECS/Kernel/Archetype.h"
 #include "Runtime/ECS/Kernel/ArchetypeManager.h"
 #include "Runtime/ECS/Kernel/Chunk.h"
+#include "Runtime/ECS/Kernel/ChunkView.h"
+#include "Runtime/ECS/Kernel/ComponentLookup.h"
 #include "Runtime/ECS/Kernel/Entity.h"
 #include "Runtime/ECS/Kernel/EntityBuilder.h"
+#include "Runtime/ECS/Kernel/EntityCommandBuffer.h"
 #include "Runtime/ECS/Kernel/EntityManager.h"
+#include "Runtime/ECS/Kernel/ObserverRegistry.h"
+#include "Runtime/ECS/Kernel/Query.h"
+#include "Runtime/ECS/Kernel/QueryState.h"
+#include "Runtime/ECS/Kernel/QueryTerm.h"
+#include "Runtime/ECS/Kernel/ResourceStore.h"
+#include "Runtime/ECS/Kernel/SharedComponentStore.h"
 #include "Runtime/ECS/Kernel/System.h"
 #include "Runtime/ECS/Kernel/World.h"
+#include "Runtime/ECS/Kernel/WorldSnapshot.h"
+#include "Runtime/ECS/Kernel/WorldStats.h"
 #include "Runtime/Graphics/Core/ConstantBuffer.h"
 #include "Runtime/Graphics/Core/GraphicsContext.h"
 #include "Runtime/Graphics/Core/RenderTarget.h"